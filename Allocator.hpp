@@ -0,0 +1,490 @@
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <new>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "Vector.hpp"
+
+//基于malloc的分配器，提供reallocate供Vector原地扩展内存
+//小块内存走realloc，大块内存直接mmap，扩展时用mremap避免拷贝
+template <typename T>
+class MallocAllocator
+{
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind { typedef MallocAllocator<U> other; };
+
+    MallocAllocator() { }
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U> &) { }
+
+    pointer allocate(size_type n);
+    void deallocate(pointer p, size_type n);
+    pointer reallocate(pointer p, size_type old_n, size_type new_n);
+
+private:
+    //超过这个字节数的内存直接向内核申请
+    static const size_t kMmapThreshold = 1 << 20;
+
+    static size_t pageRound(size_t bytes)
+    {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) / page * page;
+    }
+    static bool isMapped(size_type n)
+    {   return n * sizeof(T) >= kMmapThreshold; }
+};
+
+template <typename T>
+typename MallocAllocator<T>::pointer MallocAllocator<T>::allocate(size_type n)
+{
+    if(n == 0)
+        return NULL;
+    void *p;
+    if(isMapped(n))
+    {
+        p = mmap(NULL, pageRound(n * sizeof(T)), PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(p == MAP_FAILED)
+            p = NULL;
+    }
+    else
+        p = malloc(n * sizeof(T));
+    if(p == NULL)
+        throw std::bad_alloc();
+    return static_cast<pointer>(p);
+}
+
+template <typename T>
+void MallocAllocator<T>::deallocate(pointer p, size_type n)
+{
+    if(p == NULL)
+        return;
+    if(isMapped(n))
+        munmap(p, pageRound(n * sizeof(T)));
+    else
+        free(p);
+}
+
+template <typename T>
+typename MallocAllocator<T>::pointer
+MallocAllocator<T>::reallocate(pointer p, size_type old_n, size_type new_n)
+{
+    if(p == NULL)
+        return allocate(new_n);
+
+    if(!isMapped(old_n) && !isMapped(new_n))
+    {
+        void *q = realloc(p, new_n * sizeof(T));
+        if(q == NULL)
+            throw std::bad_alloc();
+        return static_cast<pointer>(q);
+    }
+    if(isMapped(old_n) && isMapped(new_n))
+    {
+        //内核直接调整页表，不拷贝数据
+        void *q = mremap(p, pageRound(old_n * sizeof(T)), pageRound(new_n * sizeof(T)), MREMAP_MAYMOVE);
+        if(q == MAP_FAILED)
+            throw std::bad_alloc();
+        return static_cast<pointer>(q);
+    }
+
+    //跨越阈值时只能换一块内存
+    pointer q = allocate(new_n);
+    memcpy(static_cast<void *>(q), static_cast<const void *>(p), std::min(old_n, new_n) * sizeof(T));
+    deallocate(p, old_n);
+    return q;
+}
+
+template <typename T, typename U>
+bool operator==(const MallocAllocator<T> &, const MallocAllocator<U> &)
+{   return true;    }
+template <typename T, typename U>
+bool operator!=(const MallocAllocator<T> &, const MallocAllocator<U> &)
+{   return false;   }
+
+//单调增长的内存区：分配只移动指针，最近一次分配可以原地扩展或回退
+//析构或release()时整块归还，适合同一次请求内创建的一批Vector
+class Arena
+{
+public:
+    explicit Arena(size_t block_size = 64 * 1024)
+        :head_(NULL), cur_(NULL), end_(NULL), block_size_(block_size), reserved_(0) { }
+    ~Arena() { release(); }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t bytes, size_t align);
+    void deallocate(void *p, size_t bytes);
+    void *reallocate(void *p, size_t old_bytes, size_t new_bytes, size_t align);
+    //归还所有内存块，之前分配的内存全部失效
+    void release();
+
+    //从系统申请的字节数
+    size_t reserved() const { return reserved_; }
+
+private:
+    struct Block
+    {
+        Block *next;
+        size_t size;
+    };
+
+    static char *alignUp(char *p, size_t align)
+    {
+        uintptr_t v = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char *>((v + align - 1) & ~(uintptr_t(align) - 1));
+    }
+    void newBlock(size_t bytes);
+
+    Block *head_; //内存块链表
+    char *cur_; //当前块中下一个可用的位置
+    char *end_; //当前块的末尾
+    size_t block_size_;
+    size_t reserved_;
+};
+
+inline void *Arena::allocate(size_t bytes, size_t align)
+{
+    char *p = alignUp(cur_, align);
+    if(cur_ == NULL || bytes > static_cast<size_t>(end_ - cur_) || p + bytes > end_)
+    {
+        newBlock(bytes + align);
+        p = alignUp(cur_, align);
+    }
+    cur_ = p + bytes;
+    return p;
+}
+
+inline void Arena::deallocate(void *p, size_t bytes)
+{
+    //只能回退最近一次分配，其余的等release()统一归还
+    if(p != NULL && static_cast<char *>(p) + bytes == cur_)
+        cur_ = static_cast<char *>(p);
+}
+
+inline void *Arena::reallocate(void *p, size_t old_bytes, size_t new_bytes, size_t align)
+{
+    char *q = static_cast<char *>(p);
+    if(q != NULL && q + old_bytes == cur_ && new_bytes <= static_cast<size_t>(end_ - q))
+    {
+        cur_ = q + new_bytes; //最近一次分配，原地扩展
+        return p;
+    }
+    void *r = allocate(new_bytes, align);
+    if(p != NULL)
+        memcpy(r, p, std::min(old_bytes, new_bytes));
+    return r;
+}
+
+inline void Arena::release()
+{
+    while(head_)
+    {
+        Block *next = head_->next;
+        free(head_);
+        head_ = next;
+    }
+    cur_ = end_ = NULL;
+    reserved_ = 0;
+}
+
+inline void Arena::newBlock(size_t bytes)
+{
+    size_t size = std::max(block_size_, bytes + sizeof(Block));
+    Block *b = static_cast<Block *>(malloc(size));
+    if(b == NULL)
+        throw std::bad_alloc();
+    b->next = head_;
+    b->size = size;
+    head_ = b;
+    cur_ = reinterpret_cast<char *>(b + 1);
+    end_ = reinterpret_cast<char *>(b) + size;
+    reserved_ += size;
+}
+
+//从Arena分配的分配器，deallocate几乎不做事，内存随Arena一起释放
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    //移动和交换时分配器随内存一起走，保证O(1)
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <typename U>
+    struct rebind { typedef ArenaAllocator<U> other; };
+
+    explicit ArenaAllocator(Arena &arena) :arena_(&arena) { }
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) :arena_(other.arena()) { }
+
+    pointer allocate(size_type n)
+    {   return static_cast<pointer>(arena_->allocate(n * sizeof(T), alignof(T)));  }
+    void deallocate(pointer p, size_type n)
+    {   arena_->deallocate(p, n * sizeof(T));   }
+    pointer reallocate(pointer p, size_type old_n, size_type new_n)
+    {
+        return static_cast<pointer>(
+            arena_->reallocate(p, old_n * sizeof(T), new_n * sizeof(T), alignof(T)));
+    }
+
+    Arena *arena() const { return arena_; }
+
+private:
+    Arena *arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs)
+{   return lhs.arena() == rhs.arena();    }
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs)
+{   return lhs.arena() != rhs.arena();    }
+
+//按2的幂分级的内存池：16B到4KB每级一条空闲链表，释放的块留给同级复用
+//新块从内部的Arena切出，更大的请求直接交给malloc，release()一次归还全部
+class PoolResource
+{
+public:
+    PoolResource() :large_(NULL)
+    {
+        for(size_t ix = 0; ix != kNumClasses; ++ix)
+            free_[ix] = NULL;
+    }
+    ~PoolResource() { release(); }
+
+    PoolResource(const PoolResource &) = delete;
+    PoolResource &operator=(const PoolResource &) = delete;
+
+    void *allocate(size_t bytes);
+    void deallocate(void *p, size_t bytes);
+    void release();
+
+private:
+    static const size_t kMinShift = 4; //最小一级16字节
+    static const size_t kNumClasses = 9; //最大一级4KB
+    static const size_t kAlign = 16;
+
+    struct FreeNode { FreeNode *next; };
+    //大块内存前面的链表头，保证release()能找到它
+    struct LargeHeader
+    {
+        LargeHeader *prev;
+        LargeHeader *next;
+    };
+
+    static size_t classIndex(size_t bytes)
+    {
+        if(bytes <= (size_t(1) << kMinShift))
+            return 0;
+        return (sizeof(unsigned long) * 8 - __builtin_clzl(bytes - 1)) - kMinShift;
+    }
+
+    FreeNode *free_[kNumClasses];
+    LargeHeader *large_;
+    Arena slabs_;
+};
+
+inline void *PoolResource::allocate(size_t bytes)
+{
+    size_t ix = classIndex(bytes);
+    if(ix < kNumClasses)
+    {
+        FreeNode *node = free_[ix];
+        if(node)
+        {
+            free_[ix] = node->next;
+            return node;
+        }
+        return slabs_.allocate(size_t(1) << (ix + kMinShift), kAlign);
+    }
+
+    void *raw = malloc(sizeof(LargeHeader) + bytes);
+    if(raw == NULL)
+        throw std::bad_alloc();
+    LargeHeader *h = static_cast<LargeHeader *>(raw);
+    h->prev = NULL;
+    h->next = large_;
+    if(large_)
+        large_->prev = h;
+    large_ = h;
+    return h + 1;
+}
+
+inline void PoolResource::deallocate(void *p, size_t bytes)
+{
+    if(p == NULL)
+        return;
+    size_t ix = classIndex(bytes);
+    if(ix < kNumClasses)
+    {
+        FreeNode *node = static_cast<FreeNode *>(p);
+        node->next = free_[ix];
+        free_[ix] = node;
+        return;
+    }
+
+    LargeHeader *h = static_cast<LargeHeader *>(p) - 1;
+    if(h->prev)
+        h->prev->next = h->next;
+    else
+        large_ = h->next;
+    if(h->next)
+        h->next->prev = h->prev;
+    free(h);
+}
+
+inline void PoolResource::release()
+{
+    while(large_)
+    {
+        LargeHeader *next = large_->next;
+        free(large_);
+        large_ = next;
+    }
+    for(size_t ix = 0; ix != kNumClasses; ++ix)
+        free_[ix] = NULL;
+    slabs_.release();
+}
+
+//从PoolResource分配的分配器
+template <typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <typename U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+    explicit PoolAllocator(PoolResource &pool) :pool_(&pool) { }
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) :pool_(other.pool()) { }
+
+    pointer allocate(size_type n)
+    {
+        static_assert(alignof(T) <= 16, "PoolAllocator only guarantees 16-byte alignment");
+        return static_cast<pointer>(pool_->allocate(n * sizeof(T)));
+    }
+    void deallocate(pointer p, size_type n)
+    {   pool_->deallocate(p, n * sizeof(T));    }
+
+    PoolResource *pool() const { return pool_; }
+
+private:
+    PoolResource *pool_;
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T> &lhs, const PoolAllocator<U> &rhs)
+{   return lhs.pool() == rhs.pool();  }
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T> &lhs, const PoolAllocator<U> &rhs)
+{   return lhs.pool() != rhs.pool();  }
+
+//按Align字节对齐的分配器，供SIMD内核使用：
+//  Vector<float, AlignedAllocator<float, 32> > v; 之后v.data()按32字节对齐
+//字节数向上取整到Align的倍数并计入容量，从任何对齐的位置按Align字节读取都不会越过缓冲区
+//不小于kHugePage的请求按大页对齐，并用madvise(MADV_HUGEPAGE)建议内核使用透明大页
+template <typename T, size_t Align = 64>
+class AlignedAllocator
+{
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "AlignedAllocator alignment must be a power of two");
+    static_assert(Align >= alignof(T), "AlignedAllocator alignment is weaker than alignof(T)");
+    static_assert(Align % sizeof(void *) == 0, "posix_memalign needs a multiple of sizeof(void *)");
+
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    static const size_t alignment = Align;
+    static const size_t kHugePage = size_t(2) << 20;
+
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+    AlignedAllocator() { }
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align> &) { }
+
+    allocation_result<pointer> allocate_at_least(size_type n);
+    pointer allocate(size_type n)
+    {   return allocate_at_least(n).ptr;   }
+    void deallocate(pointer p, size_type /*n*/)
+    {   free(p);    }
+
+    size_type max_size() const
+    {   return (static_cast<size_t>(-1) - kHugePage) / sizeof(T);    }
+};
+
+template <typename T, size_t Align>
+const size_t AlignedAllocator<T, Align>::alignment;
+template <typename T, size_t Align>
+const size_t AlignedAllocator<T, Align>::kHugePage;
+
+template <typename T, size_t Align>
+allocation_result<typename AlignedAllocator<T, Align>::pointer>
+AlignedAllocator<T, Align>::allocate_at_least(size_type n)
+{
+    if(n > max_size())
+        throw std::bad_alloc();
+    size_t bytes = n * sizeof(T);
+    size_t align = Align;
+    if(bytes >= kHugePage)
+        align = std::max(align, kHugePage); //大页对齐，整块都能被大页覆盖
+    bytes = (std::max<size_t>(bytes, 1) + align - 1) & ~(align - 1);
+
+    void *p;
+    if(posix_memalign(&p, align, bytes) != 0)
+        throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+    if(align >= kHugePage)
+        madvise(p, bytes, MADV_HUGEPAGE); //只是建议，失败时仍然使用普通页
+#endif
+
+    allocation_result<pointer> result;
+    result.ptr = static_cast<pointer>(p);
+    result.count = bytes / sizeof(T);
+    return result;
+}
+
+template <typename T, size_t A1, typename U, size_t A2>
+bool operator==(const AlignedAllocator<T, A1> &, const AlignedAllocator<U, A2> &)
+{   return A1 == A2;    }
+template <typename T, size_t A1, typename U, size_t A2>
+bool operator!=(const AlignedAllocator<T, A1> &, const AlignedAllocator<U, A2> &)
+{   return A1 != A2;    }
+
+#endif  /* ALLOCATOR_HPP */
@@ -0,0 +1,531 @@
+#ifndef BITVECTOR_HPP
+#define BITVECTOR_HPP
+
+#include "Vector.hpp"
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BIT_KERNELS_X86 1
+#endif
+
+//BitVector使用的按字处理的内核，和vector_compare一样运行时按CPU选择实现：
+//  popcount   AVX2用查表法一次数256位，其次用popcnt指令，最后是编译器的软件实现
+//  与或异或   AVX2一次处理4个字，否则逐字处理
+namespace bit_kernels
+{
+
+inline uint64_t popcountScalar(const uint64_t *p, size_t n)
+{
+    uint64_t total = 0;
+    for(size_t ix = 0; ix != n; ++ix)
+        total += __builtin_popcountll(p[ix]);
+    return total;
+}
+
+#ifdef BIT_KERNELS_X86
+__attribute__((target("popcnt")))
+inline uint64_t popcountHw(const uint64_t *p, size_t n)
+{
+    uint64_t total = 0;
+    for(size_t ix = 0; ix != n; ++ix)
+        total += __builtin_popcountll(p[ix]);
+    return total;
+}
+
+//每个字节拆成两个4位，用vpshufb查表得到各自的1的个数，再用vpsadbw横向累加
+__attribute__((target("avx2,popcnt")))
+inline uint64_t popcountAvx2(const uint64_t *p, size_t n)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+    size_t ix = 0;
+    while(ix + 4 <= n)
+    {
+        //每个字节每轮最多加8，累加8轮后不会溢出
+        __m256i local = zero;
+        for(int round = 0; round != 8 && ix + 4 <= n; ++round, ix += 4)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + ix));
+            __m256i lo = _mm256_and_si256(v, low);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+            local = _mm256_add_epi8(local, _mm256_shuffle_epi8(lookup, lo));
+            local = _mm256_add_epi8(local, _mm256_shuffle_epi8(lookup, hi));
+        }
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(local, zero));
+    }
+    uint64_t total = static_cast<uint64_t>(_mm256_extract_epi64(acc, 0)) + _mm256_extract_epi64(acc, 1)
+                   + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+    for(; ix != n; ++ix)
+        total += __builtin_popcountll(p[ix]);
+    return total;
+}
+#endif
+
+inline bool hasAvx2()
+{
+#ifdef BIT_KERNELS_X86
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+typedef uint64_t (*PopcountFn)(const uint64_t *, size_t);
+
+inline PopcountFn selectPopcount()
+{
+#ifdef BIT_KERNELS_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+        return popcountAvx2;
+    if(__builtin_cpu_supports("popcnt"))
+        return popcountHw;
+#endif
+    return popcountScalar;
+}
+
+//[p, p + n)中1的个数
+inline uint64_t popcount(const uint64_t *p, size_t n)
+{
+    static const PopcountFn fn = selectPopcount();
+    return fn(p, n);
+}
+
+//w中第k个（从0开始）1的位置，k小于w中1的个数
+inline unsigned selectInWord(uint64_t w, unsigned k)
+{
+    for(; k; --k)
+        w &= w - 1;
+    return __builtin_ctzll(w);
+}
+
+//逐字运算：word处理一个字，vec处理4个字
+struct AndOp
+{
+    static uint64_t word(uint64_t a, uint64_t b) { return a & b; }
+#ifdef BIT_KERNELS_X86
+    __attribute__((target("avx2"))) static __m256i vec(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+#endif
+};
+
+struct OrOp
+{
+    static uint64_t word(uint64_t a, uint64_t b) { return a | b; }
+#ifdef BIT_KERNELS_X86
+    __attribute__((target("avx2"))) static __m256i vec(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+#endif
+};
+
+struct XorOp
+{
+    static uint64_t word(uint64_t a, uint64_t b) { return a ^ b; }
+#ifdef BIT_KERNELS_X86
+    __attribute__((target("avx2"))) static __m256i vec(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+#endif
+};
+
+struct AndNotOp
+{
+    static uint64_t word(uint64_t a, uint64_t b) { return a & ~b; }
+#ifdef BIT_KERNELS_X86
+    __attribute__((target("avx2"))) static __m256i vec(__m256i a, __m256i b) { return _mm256_andnot_si256(b, a); }
+#endif
+};
+
+template <typename Op>
+void applyScalar(uint64_t *dst, const uint64_t *src, size_t n)
+{
+    for(size_t ix = 0; ix != n; ++ix)
+        dst[ix] = Op::word(dst[ix], src[ix]);
+}
+
+#ifdef BIT_KERNELS_X86
+template <typename Op>
+__attribute__((target("avx2")))
+void applyAvx2(uint64_t *dst, const uint64_t *src, size_t n)
+{
+    size_t ix = 0;
+    for(; ix + 4 <= n; ix += 4)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + ix));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + ix));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + ix), Op::vec(a, b));
+    }
+    for(; ix != n; ++ix)
+        dst[ix] = Op::word(dst[ix], src[ix]);
+}
+#endif
+
+//dst[i] = Op(dst[i], src[i])
+template <typename Op>
+void apply(uint64_t *dst, const uint64_t *src, size_t n)
+{
+#ifdef BIT_KERNELS_X86
+    if(hasAvx2())
+    {
+        applyAvx2<Op>(dst, src, n);
+        return;
+    }
+#endif
+    applyScalar<Op>(dst, src, n);
+}
+
+}
+
+//按位存放的bool序列，每个元素占1位，存放在Vector<uint64_t>中，扩容沿用Vector的增长策略
+//operator[]返回代理引用；最后一个字中超出size()的位始终为0，按字统计和查找不需要特殊处理末尾
+//没有特化Vector<bool>：特化会改变Vector<bool>的元素类型和引用语义，需要时直接使用BitVector
+template <typename Alloc = std::allocator<uint64_t>, typename Growth = GrowDouble>
+class BitVector
+{
+public:
+    typedef bool value_type;
+    typedef bool const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef uint64_t word_type;
+    typedef Vector<uint64_t, Alloc, Growth> word_vector;
+
+    static const size_type npos = static_cast<size_type>(-1);
+    static const size_type kWordBits = 64;
+
+    //指向一位的代理
+    class reference
+    {
+    public:
+        reference(word_type *word, word_type mask) :word_(word), mask_(mask) { }
+
+        operator bool() const { return (*word_ & mask_) != 0; }
+        reference &operator=(bool v)
+        {
+            *word_ = v ? (*word_ | mask_) : (*word_ & ~mask_);
+            return *this;
+        }
+        reference &operator=(const reference &other) { return *this = static_cast<bool>(other); }
+        bool operator~() const { return !static_cast<bool>(*this); }
+        void flip() { *word_ ^= mask_; }
+
+    private:
+        word_type *word_;
+        word_type mask_;
+    };
+
+    template <typename Ref, typename Word>
+    class basic_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef bool value_type;
+        typedef ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef Ref reference;
+
+        basic_iterator() :words_(NULL), pos_(0) { }
+        basic_iterator(Word *words, size_type pos) :words_(words), pos_(pos) { }
+        //提供从iterator到const_iterator的转换
+        template <typename R, typename W>
+        basic_iterator(const basic_iterator<R, W> &it) :words_(it.words_), pos_(it.pos_) { }
+
+        reference operator*() const { return BitVector::at(words_, pos_); }
+        reference operator[](difference_type d) const { return BitVector::at(words_, pos_ + d); }
+
+        basic_iterator &operator++() { ++pos_; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp(*this); ++pos_; return temp; }
+        basic_iterator &operator--() { --pos_; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp(*this); --pos_; return temp; }
+        basic_iterator &operator+=(difference_type d) { pos_ += d; return *this; }
+        basic_iterator &operator-=(difference_type d) { pos_ -= d; return *this; }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type d) { return it += d; }
+        friend basic_iterator operator+(difference_type d, basic_iterator it) { return it += d; }
+        friend basic_iterator operator-(basic_iterator it, difference_type d) { return it -= d; }
+        friend difference_type operator-(const basic_iterator &i, const basic_iterator &j)
+        {   return static_cast<difference_type>(i.pos_) - static_cast<difference_type>(j.pos_);    }
+
+        friend bool operator==(const basic_iterator &i, const basic_iterator &j) { return i.pos_ == j.pos_; }
+        friend bool operator!=(const basic_iterator &i, const basic_iterator &j) { return i.pos_ != j.pos_; }
+        friend bool operator<(const basic_iterator &i, const basic_iterator &j) { return i.pos_ < j.pos_; }
+        friend bool operator>(const basic_iterator &i, const basic_iterator &j) { return i.pos_ > j.pos_; }
+        friend bool operator<=(const basic_iterator &i, const basic_iterator &j) { return i.pos_ <= j.pos_; }
+        friend bool operator>=(const basic_iterator &i, const basic_iterator &j) { return i.pos_ >= j.pos_; }
+
+    private:
+        template <typename R, typename W>
+        friend class basic_iterator;
+
+        Word *words_;
+        size_type pos_;
+    };
+
+    typedef basic_iterator<reference, word_type> iterator;
+    typedef basic_iterator<bool, const word_type> const_iterator;
+
+    BitVector() :size_(0) { }
+    explicit BitVector(size_type n, bool val = false)
+        :words_(wordsFor(n), val ? ~word_type(0) : 0), size_(n)
+    { clearTail(); }
+
+    iterator begin() { return iterator(words_.data(), 0); }
+    iterator end() { return iterator(words_.data(), size_); }
+    const_iterator begin() const { return const_iterator(words_.data(), 0); }
+    const_iterator end() const { return const_iterator(words_.data(), size_); }
+
+    reference operator[] (size_type n) { return at(words_.data(), n); }
+    bool operator[] (size_type n) const { return test(n); }
+    bool test(size_type n) const { return (words_[n / kWordBits] >> (n % kWordBits)) & 1; }
+    bool front() const { return test(0); }
+    bool back() const { return test(size_ - 1); }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return words_.capacity() * kWordBits; }
+    void reserve(size_type n) { words_.reserve(wordsFor(n)); }
+    void clear()
+    {
+        words_.clear();
+        size_ = 0;
+    }
+    void shrink_to_fit() { words_.shrink_to_fit(); }
+
+    //按字访问，最后一个字中超出size()的位为0，修改时要保持这一点
+    word_type *data() { return words_.data(); }
+    const word_type *data() const { return words_.data(); }
+    const word_vector &words() const { return words_; }
+    size_type num_words() const { return words_.size(); }
+
+    void push_back(bool v)
+    {
+        if(size_ % kWordBits == 0)
+            words_.push_back(0);
+        if(v)
+            words_.back() |= mask(size_);
+        ++size_;
+    }
+    void pop_back()
+    {
+        --size_;
+        if(size_ % kWordBits == 0)
+            words_.pop_back();
+        else
+            words_.back() &= ~mask(size_);
+    }
+    void resize(size_type n, bool val = false);
+
+    void set(size_type n, bool v = true) { (*this)[n] = v; }
+    void reset(size_type n) { words_[n / kWordBits] &= ~mask(n); }
+    void flip(size_type n) { words_[n / kWordBits] ^= mask(n); }
+    //对全部元素
+    void set();
+    void reset() { std::fill(words_.begin(), words_.end(), word_type(0)); }
+    void flip();
+
+    //逐位运算，两边的size()必须相同，否则抛出invalid_argument
+    BitVector &operator&=(const BitVector &rhs) { return apply<bit_kernels::AndOp>(rhs); }
+    BitVector &operator|=(const BitVector &rhs) { return apply<bit_kernels::OrOp>(rhs); }
+    BitVector &operator^=(const BitVector &rhs) { return apply<bit_kernels::XorOp>(rhs); }
+    BitVector &and_not(const BitVector &rhs) { return apply<bit_kernels::AndNotOp>(rhs); } //*this & ~rhs
+
+    //1的个数
+    size_type count() const { return bit_kernels::popcount(words_.data(), words_.size()); }
+    bool any() const { return find_first() != npos; }
+    bool none() const { return !any(); }
+    //第一个1的位置，没有时返回npos
+    size_type find_first() const { return findFrom(0); }
+    //pos之后（不含pos）的第一个1的位置，没有时返回npos
+    size_type find_next(size_type pos) const { return pos + 1 >= size_ ? npos : findFrom(pos + 1); }
+    //[0, pos)中1的个数，逐字统计；需要频繁查询时使用BitRankIndex
+    size_type rank(size_type pos) const;
+    //第k个（从0开始）1的位置，没有时返回npos
+    size_type select(size_type k) const;
+
+    void swap(BitVector &other)
+    {
+        words_.swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    friend bool operator==(const BitVector &lhs, const BitVector &rhs)
+    {   return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;  }
+    friend bool operator!=(const BitVector &lhs, const BitVector &rhs)
+    {   return !(lhs == rhs);   }
+
+private:
+    template <typename R, typename W>
+    friend class basic_iterator;
+
+    static size_type wordsFor(size_type n) { return (n + kWordBits - 1) / kWordBits; }
+    static word_type mask(size_type n) { return word_type(1) << (n % kWordBits); }
+
+    static reference at(word_type *words, size_type n)
+    {   return reference(words + n / kWordBits, mask(n));   }
+    static bool at(const word_type *words, size_type n)
+    {   return (words[n / kWordBits] >> (n % kWordBits)) & 1;    }
+
+    //把最后一个字中超出size()的位清零
+    void clearTail()
+    {
+        if(size_ % kWordBits)
+            words_.back() &= mask(size_) - 1;
+    }
+
+    template <typename Op>
+    BitVector &apply(const BitVector &rhs);
+    size_type findFrom(size_type pos) const;
+
+    word_vector words_;
+    size_type size_; //位数
+};
+
+template <typename Alloc, typename Growth>
+const typename BitVector<Alloc, Growth>::size_type BitVector<Alloc, Growth>::npos;
+template <typename Alloc, typename Growth>
+const typename BitVector<Alloc, Growth>::size_type BitVector<Alloc, Growth>::kWordBits;
+
+template <typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::resize(size_type n, bool val)
+{
+    size_type old = size_;
+    words_.resize(wordsFor(n), val ? ~word_type(0) : 0);
+    if(n > old && val && old % kWordBits)
+        words_[old / kWordBits] |= ~(mask(old) - 1); //原来最后一个字中新增的位
+    size_ = n;
+    clearTail();
+}
+
+template <typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::set()
+{
+    std::fill(words_.begin(), words_.end(), ~word_type(0));
+    clearTail();
+}
+
+template <typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::flip()
+{
+    for(typename word_vector::iterator it = words_.begin(); it != words_.end(); ++it)
+        *it = ~*it;
+    clearTail();
+}
+
+template <typename Alloc, typename Growth>
+template <typename Op>
+BitVector<Alloc, Growth> &BitVector<Alloc, Growth>::apply(const BitVector &rhs)
+{
+    if(size_ != rhs.size_)
+        throw std::invalid_argument("BitVector: size mismatch");
+    bit_kernels::apply<Op>(words_.data(), rhs.words_.data(), words_.size());
+    return *this;
+}
+
+template <typename Alloc, typename Growth>
+typename BitVector<Alloc, Growth>::size_type BitVector<Alloc, Growth>::findFrom(size_type pos) const
+{
+    if(pos >= size_)
+        return npos;
+    size_type ix = pos / kWordBits;
+    word_type w = words_[ix] & ~(mask(pos) - 1); //去掉pos之前的位
+    while(w == 0)
+    {
+        if(++ix == words_.size())
+            return npos;
+        w = words_[ix];
+    }
+    return ix * kWordBits + __builtin_ctzll(w);
+}
+
+template <typename Alloc, typename Growth>
+typename BitVector<Alloc, Growth>::size_type BitVector<Alloc, Growth>::rank(size_type pos) const
+{
+    size_type full = pos / kWordBits;
+    size_type r = bit_kernels::popcount(words_.data(), full);
+    if(pos % kWordBits)
+        r += __builtin_popcountll(words_[full] & (mask(pos) - 1));
+    return r;
+}
+
+template <typename Alloc, typename Growth>
+typename BitVector<Alloc, Growth>::size_type BitVector<Alloc, Growth>::select(size_type k) const
+{
+    for(size_type ix = 0; ix != words_.size(); ++ix)
+    {
+        size_type c = __builtin_popcountll(words_[ix]);
+        if(k < c)
+            return ix * kWordBits + bit_kernels::selectInWord(words_[ix], static_cast<unsigned>(k));
+        k -= c;
+    }
+    return npos;
+}
+
+//BitVector的rank/select索引：每512位记录之前1的个数，rank是O(1)，select是对块的二分加块内扫描
+//索引保存的是位数据的指针，BitVector修改或扩容后要重新构造
+class BitRankIndex
+{
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    template <typename Alloc, typename Growth>
+    explicit BitRankIndex(const BitVector<Alloc, Growth> &bits)
+    {   build(bits.data(), bits.num_words(), bits.size());   }
+
+    //[0, pos)中1的个数
+    size_t rank(size_t pos) const
+    {
+        size_t word = pos / 64, block = word / kBlockWords;
+        size_t r = blocks_[block];
+        for(size_t ix = block * kBlockWords; ix != word; ++ix)
+            r += __builtin_popcountll(words_[ix]);
+        if(pos % 64)
+            r += __builtin_popcountll(words_[word] & ((uint64_t(1) << (pos % 64)) - 1));
+        return r;
+    }
+    //第k个（从0开始）1的位置，没有时返回npos
+    size_t select(size_t k) const;
+    size_t count() const { return blocks_.back(); }
+
+private:
+    enum { kBlockWords = 8 };
+
+    void build(const uint64_t *words, size_t num_words, size_t bits);
+
+    const uint64_t *words_;
+    size_t num_words_;
+    Vector<size_t> blocks_; //blocks_[b]是第b块之前1的个数，最后多一项总数
+};
+
+inline void BitRankIndex::build(const uint64_t *words, size_t num_words, size_t /*bits*/)
+{
+    words_ = words;
+    num_words_ = num_words;
+    size_t num_blocks = (num_words + kBlockWords - 1) / kBlockWords;
+    blocks_.resize_uninitialized(num_blocks + 1);
+    size_t total = 0;
+    for(size_t b = 0; b != num_blocks; ++b)
+    {
+        blocks_[b] = total;
+        total += bit_kernels::popcount(words + b * kBlockWords, std::min<size_t>(kBlockWords, num_words - b * kBlockWords));
+    }
+    blocks_[num_blocks] = total;
+}
+
+inline size_t BitRankIndex::select(size_t k) const
+{
+    if(k >= count())
+        return npos;
+    //最后一个之前1的个数不超过k的块
+    size_t block = std::upper_bound(blocks_.begin(), blocks_.end(), k) - blocks_.begin() - 1;
+    k -= blocks_[block];
+    for(size_t ix = block * kBlockWords; ; ++ix)
+    {
+        size_t c = __builtin_popcountll(words_[ix]);
+        if(k < c)
+            return ix * 64 + bit_kernels::selectInWord(words_[ix], static_cast<unsigned>(k));
+        k -= c;
+    }
+}
+
+#endif  /* BITVECTOR_HPP */
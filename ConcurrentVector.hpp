@@ -0,0 +1,231 @@
+#ifndef CONCURRENTVECTOR_HPP
+#define CONCURRENTVECTOR_HPP
+
+#include "Vector.hpp"
+#include <atomic>
+#include <thread>
+#include <new>
+
+//多个线程可以同时追加的Vector：
+//  push_back先保证下标所在的段已经分配，再用CAS领取下标，元素放进容量按2倍递增的段中，段分配后不再移动
+//  已发布元素的引用一直有效，operator[]不加锁也不等待
+//第k段有kFirstSegment << k个元素，第一次用到某一段的线程负责分配，CAS失败的一方释放自己的那份
+//分配器会被多个线程同时使用，必须是线程安全的
+template <typename T, typename Alloc = std::allocator<T> >
+class ConcurrentVector
+{
+public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef Alloc allocator_type;
+
+    explicit ConcurrentVector(const allocator_type &a = allocator_type());
+    ~ConcurrentVector();
+
+    ConcurrentVector(const ConcurrentVector &) = delete;
+    ConcurrentVector &operator=(const ConcurrentVector &) = delete;
+
+    //返回新元素的下标，返回之后其他线程可以通过operator[]访问它
+    size_type push_back(const T &t)
+    {   return emplace_back(t);    }
+    size_type push_back(T &&t)
+    {   return emplace_back(std::move(t));  }
+    template <typename... Args>
+    size_type emplace_back(Args&&... args);
+
+    //n必须是已经发布的下标：push_back的返回值，或者ready(n)为true
+    reference operator[] (size_type n) { return slot(n).value(); }
+    const_reference operator[] (size_type n) const { return slot(n).value(); }
+
+    //下标为n的元素是否已经构造完成
+    bool ready(size_type n) const;
+    //已经领取的下标数，其中可能有元素还在构造
+    size_type size() const { return size_.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+
+    //按下标顺序把调用时已经领取的元素拷贝到连续的Vector中
+    //会等待还在构造的元素，构造时抛出异常的位置被跳过
+    Vector<T> snapshot() const;
+
+private:
+    enum { kEmpty, kReady, kFailed };
+
+    struct Slot
+    {
+        Slot() :state(kEmpty) { }
+
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        std::atomic<unsigned char> state;
+
+        T &value() { return *reinterpret_cast<T *>(&storage); }
+        const T &value() const { return *reinterpret_cast<const T *>(&storage); }
+    };
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Slot> SlotAlloc;
+    typedef std::allocator_traits<SlotAlloc> slot_traits;
+
+    static const int kFirstShift = 5;
+    static const size_type kFirstSegment = size_type(1) << kFirstShift;
+    static const int kSegments = sizeof(size_type) * 8 - kFirstShift;
+
+    static int segmentOf(size_type n)
+    {   return sizeof(size_type) * 8 - 1 - __builtin_clzl(n + kFirstSegment) - kFirstShift; }
+    static size_type segmentBase(int k) { return (kFirstSegment << k) - kFirstSegment; }
+    static size_type segmentSize(int k) { return kFirstSegment << k; }
+
+    Slot &slot(size_type n) const
+    {
+        int k = segmentOf(n);
+        return segments_[k].load(std::memory_order_acquire)[n - segmentBase(k)];
+    }
+    //返回第k段，还没有分配时分配它
+    Slot *segment(int k);
+    //构造和释放一段中的Slot，元素由调用者负责
+    Slot *allocateSegment(int k);
+    void releaseSegment(Slot *seg, int k);
+    //等到第n个位置所在的段被发布
+    const Slot &waitSlot(size_type n) const;
+
+    SlotAlloc alloc_;
+    std::atomic<size_type> size_; //下一个要领取的下标
+    mutable std::atomic<Slot *> segments_[kSegments];
+};
+
+template <typename T, typename Alloc>
+ConcurrentVector<T, Alloc>::ConcurrentVector(const allocator_type &a)
+    :alloc_(a), size_(0)
+{
+    for(int k = 0; k != kSegments; ++k)
+        segments_[k].store(NULL, std::memory_order_relaxed);
+}
+
+template <typename T, typename Alloc>
+ConcurrentVector<T, Alloc>::~ConcurrentVector()
+{
+    size_type n = size_.load(std::memory_order_acquire);
+    for(int k = 0; k != kSegments; ++k)
+    {
+        Slot *seg = segments_[k].load(std::memory_order_acquire);
+        if(seg == NULL)
+            continue;
+        for(size_type ix = 0; ix != segmentSize(k) && segmentBase(k) + ix < n; ++ix)
+            if(seg[ix].state.load(std::memory_order_relaxed) == kReady)
+                seg[ix].value().~T();
+        releaseSegment(seg, k);
+    }
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+typename ConcurrentVector<T, Alloc>::size_type
+ConcurrentVector<T, Alloc>::emplace_back(Args&&... args)
+{
+    //先保证下标所在的段已经分配再领取下标，分配失败时什么也没有领取，
+    //领取之后只剩构造元素可能失败，每个领取的位置最终都会是kReady或者kFailed
+    //release保证读到size()的线程也能看到段已经发布
+    size_type n = size_.load(std::memory_order_relaxed);
+    Slot *seg;
+    do
+        seg = segment(segmentOf(n));
+    while(!size_.compare_exchange_weak(n, n + 1, std::memory_order_release, std::memory_order_relaxed));
+    int k = segmentOf(n);
+    size_type offset = n - segmentBase(k);
+    Slot &s = seg[offset];
+    //用到一段的一半时提前分配下一段，其他线程很少需要等待或者重复分配；
+    //提前分配失败不影响这个元素，用到下一段时会再分配
+    if(offset == segmentSize(k) / 2 && k + 1 != kSegments)
+    {
+        try
+        {
+            segment(k + 1);
+        }
+        catch(...)
+        {
+        }
+    }
+
+    try
+    {
+        ::new (static_cast<void *>(&s.storage)) T(std::forward<Args>(args)...);
+    }
+    catch(...)
+    {
+        s.state.store(kFailed, std::memory_order_release);
+        throw;
+    }
+    s.state.store(kReady, std::memory_order_release);
+    return n;
+}
+
+template <typename T, typename Alloc>
+typename ConcurrentVector<T, Alloc>::Slot *ConcurrentVector<T, Alloc>::segment(int k)
+{
+    Slot *seg = segments_[k].load(std::memory_order_acquire);
+    if(seg != NULL)
+        return seg;
+
+    Slot *fresh = allocateSegment(k);
+    if(segments_[k].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+        return fresh;
+    releaseSegment(fresh, k); //其他线程抢先分配了
+    return seg;
+}
+
+template <typename T, typename Alloc>
+typename ConcurrentVector<T, Alloc>::Slot *ConcurrentVector<T, Alloc>::allocateSegment(int k)
+{
+    Slot *seg = slot_traits::allocate(alloc_, segmentSize(k));
+    for(size_type ix = 0; ix != segmentSize(k); ++ix)
+        slot_traits::construct(alloc_, seg + ix); //Slot的构造不抛出异常
+    return seg;
+}
+
+template <typename T, typename Alloc>
+void ConcurrentVector<T, Alloc>::releaseSegment(Slot *seg, int k)
+{
+    for(size_type ix = 0; ix != segmentSize(k); ++ix)
+        slot_traits::destroy(alloc_, seg + ix);
+    slot_traits::deallocate(alloc_, seg, segmentSize(k));
+}
+
+template <typename T, typename Alloc>
+const typename ConcurrentVector<T, Alloc>::Slot &ConcurrentVector<T, Alloc>::waitSlot(size_type n) const
+{
+    int k = segmentOf(n);
+    Slot *seg;
+    while((seg = segments_[k].load(std::memory_order_acquire)) == NULL)
+        std::this_thread::yield();
+    return seg[n - segmentBase(k)];
+}
+
+template <typename T, typename Alloc>
+bool ConcurrentVector<T, Alloc>::ready(size_type n) const
+{
+    if(n >= size())
+        return false;
+    Slot *seg = segments_[segmentOf(n)].load(std::memory_order_acquire);
+    return seg != NULL
+        && seg[n - segmentBase(segmentOf(n))].state.load(std::memory_order_acquire) == kReady;
+}
+
+template <typename T, typename Alloc>
+Vector<T> ConcurrentVector<T, Alloc>::snapshot() const
+{
+    size_type n = size();
+    Vector<T> result;
+    result.reserve(n);
+    for(size_type ix = 0; ix != n; ++ix)
+    {
+        const Slot &s = waitSlot(ix);
+        unsigned char state;
+        while((state = s.state.load(std::memory_order_acquire)) == kEmpty)
+            std::this_thread::yield();
+        if(state == kReady)
+            result.push_back(s.value());
+    }
+    return result;
+}
+
+#endif  /* CONCURRENTVECTOR_HPP */
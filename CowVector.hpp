@@ -0,0 +1,246 @@
+#ifndef COWVECTOR_HPP
+#define COWVECTOR_HPP
+
+#include "Vector.hpp"
+#include <atomic>
+
+//写时复制的Vector：拷贝只增加引用计数，第一次修改时才复制元素
+//适合把同一份大的只读数据分给很多线程：
+//  CowVector<Entry> table(std::move(loaded));
+//  for(...) workers.push_back(Worker(table)); //每个worker拿到的只是一个指针
+//引用计数是原子的，不同的CowVector对象共享同一份数据时可以在不同线程中使用，
+//但同一个CowVector对象不能在一个线程修改的同时被其他线程读取
+//只读访问通过const成员函数；修改元素要先调用make_unique()拿到独占的Vector
+//共享块和其中的Vector都用容器保存的分配器分配，有状态的分配器(如ArenaAllocator)也会被使用
+template <typename T, typename Alloc = std::allocator<T> >
+class CowVector : private VectorAllocHolder<Alloc>
+{
+    typedef VectorAllocHolder<Alloc> AllocHolder;
+    typedef std::allocator_traits<Alloc> alloc_traits;
+
+public:
+    typedef Vector<T, Alloc> vector_type;
+    typedef T value_type;
+    typedef const T *const_iterator;
+    typedef const T &const_reference;
+    typedef const T *const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef Alloc allocator_type;
+
+    CowVector() :shared_(NULL) { } //空容器不分配内存
+    explicit CowVector(const allocator_type &a) :AllocHolder(a), shared_(NULL) { }
+    explicit CowVector(size_type n, const value_type &val = value_type(),
+                       const allocator_type &a = allocator_type())
+        :AllocHolder(a), shared_(NULL)
+    { if(n) shared_ = acquire(vector_type(n, val, alloc())); }
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    CowVector(In i, In j, const allocator_type &a = allocator_type())
+        :AllocHolder(a), shared_(NULL)
+    { if(i != j) shared_ = acquire(vector_type(i, j, alloc())); }
+    //接管v的内存，不复制元素，使用v的分配器
+    explicit CowVector(vector_type &&v) :AllocHolder(v.get_allocator()), shared_(NULL)
+    { if(!v.empty()) shared_ = acquire(std::move(v)); }
+
+    CowVector(const CowVector &other)
+        :AllocHolder(alloc_traits::select_on_container_copy_construction(other.alloc())),
+         shared_(other.shared_)
+    {
+        if(shared_)
+            shared_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    CowVector(CowVector &&other) noexcept
+        :AllocHolder(std::move(other.alloc())), shared_(other.shared_)
+    { other.shared_ = NULL; }
+    CowVector &operator=(CowVector rhs) noexcept
+    {
+        swap(rhs);
+        return *this;
+    }
+    ~CowVector() { release(shared_); }
+
+    //共享块自己记得分配器，交换指针总是安全的；分配器按POCS决定是否交换
+    void swap(CowVector &other) noexcept
+    {
+        if(alloc_traits::propagate_on_container_swap::value)
+        {
+            using std::swap;
+            swap(alloc(), other.alloc());
+        }
+        std::swap(shared_, other.shared_);
+    }
+
+    allocator_type get_allocator() const { return alloc(); }
+
+    const_iterator begin() const { return shared_ ? shared_->vec.begin() : NULL; }
+    const_iterator end() const { return shared_ ? shared_->vec.end() : NULL; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const T *data() const { return begin(); }
+
+    const_reference operator[] (size_type n) const { return shared_->vec[n]; }
+    const_reference at(size_type n) const
+    {
+        if(n >= size())
+            throw std::out_of_range("CowVector::at");
+        return (*this)[n];
+    }
+    const_reference front() const { return shared_->vec.front(); }
+    const_reference back() const { return shared_->vec.back(); }
+
+    bool empty() const { return size() == 0; }
+    size_type size() const { return shared_ ? shared_->vec.size() : 0; }
+    size_type capacity() const { return shared_ ? shared_->vec.capacity() : 0; }
+
+    //共享同一份数据的CowVector个数，空容器返回0；其他线程可能同时在拷贝或析构，结果只作参考
+    long use_count() const
+    {   return shared_ ? static_cast<long>(shared_->refs.load(std::memory_order_relaxed)) : 0;   }
+    bool unique() const { return use_count() <= 1; }
+
+    //保证数据只被自己持有，必要时复制一份；返回的引用在下一次拷贝本对象之前有效
+    vector_type &make_unique()
+    {
+        CowVector old(alloc());
+        return make_unique(old);
+    }
+
+    //修改操作都先取得独占的数据；参数可能引用共享数据中的元素，旧数据保留到操作结束
+    void push_back(const value_type &val)
+    {
+        CowVector old(alloc());
+        make_unique(old).push_back(val);
+    }
+    void push_back(value_type &&val)
+    {
+        CowVector old(alloc());
+        make_unique(old).push_back(std::move(val));
+    }
+    template <typename... Args>
+    void emplace_back(Args&&... args)
+    {
+        CowVector old(alloc());
+        make_unique(old).emplace_back(std::forward<Args>(args)...);
+    }
+    void pop_back() { make_unique().pop_back(); }
+    void resize(size_type n, const value_type &val = value_type())
+    {
+        CowVector old(alloc());
+        make_unique(old).resize(n, val);
+    }
+    void reserve(size_type n) { make_unique().reserve(n); }
+    //返回插入或删除位置的下标，原来的迭代器在复制后会失效
+    size_type insert(const_iterator pos, const value_type &val);
+    size_type erase(const_iterator pos) { return erase(pos, pos + 1); }
+    size_type erase(const_iterator first, const_iterator last);
+    //放弃持有的数据，不复制
+    void clear()
+    {
+        Shared *s = shared_;
+        shared_ = NULL;
+        release(s);
+    }
+
+    //共享同一份数据时不比较元素
+    friend bool operator==(const CowVector &lhs, const CowVector &rhs)
+    {   return lhs.shared_ == rhs.shared_ || lhs.view() == rhs.view();   }
+    friend bool operator!=(const CowVector &lhs, const CowVector &rhs)
+    {   return !(lhs == rhs);   }
+    friend bool operator<(const CowVector &lhs, const CowVector &rhs)
+    {   return lhs.view() < rhs.view();    }
+
+private:
+    struct Shared
+    {
+        explicit Shared(vector_type &&v) :refs(1), vec(std::move(v)) { }
+
+        std::atomic<size_t> refs;
+        vector_type vec;
+    };
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Shared> SharedAlloc;
+    typedef std::allocator_traits<SharedAlloc> shared_traits;
+
+    Alloc &alloc() { return AllocHolder::get(); }
+    const Alloc &alloc() const { return AllocHolder::get(); }
+
+    VectorView<const T> view() const { return VectorView<const T>(data(), size()); }
+    size_type indexOf(const_iterator pos) const { return pos - begin(); }
+
+    //复制时把原来共享的数据交给old，由调用者决定什么时候放弃
+    vector_type &make_unique(CowVector &old);
+
+    //共享块从v的分配器rebind得到，v总是用容器保存的分配器构造的；
+    //释放时从块里的Vector取回同一个分配器
+    static Shared *acquire(vector_type &&v);
+    static void release(Shared *s);
+
+    Shared *shared_;
+};
+
+template <typename T, typename Alloc>
+typename CowVector<T, Alloc>::Shared *CowVector<T, Alloc>::acquire(vector_type &&v)
+{
+    SharedAlloc a(v.get_allocator());
+    Shared *s = shared_traits::allocate(a, 1);
+    try
+    {
+        shared_traits::construct(a, s, std::move(v));
+    }
+    catch(...)
+    {
+        shared_traits::deallocate(a, s, 1);
+        throw;
+    }
+    return s;
+}
+
+template <typename T, typename Alloc>
+void CowVector<T, Alloc>::release(Shared *s)
+{
+    //acq_rel保证其他线程对数据的读取都发生在析构之前
+    if(s == NULL || s->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    SharedAlloc a(s->vec.get_allocator());
+    shared_traits::destroy(a, s);
+    shared_traits::deallocate(a, s, 1);
+}
+
+template <typename T, typename Alloc>
+typename CowVector<T, Alloc>::vector_type &CowVector<T, Alloc>::make_unique(CowVector &old)
+{
+    if(shared_ == NULL)
+        shared_ = acquire(vector_type(alloc()));
+    else if(shared_->refs.load(std::memory_order_acquire) != 1)
+    {
+        //先复制再交出旧的数据，复制抛出异常时不受影响
+        Shared *copy = acquire(vector_type(shared_->vec, alloc()));
+        old.shared_ = shared_;
+        shared_ = copy;
+    }
+    return shared_->vec;
+}
+
+template <typename T, typename Alloc>
+typename CowVector<T, Alloc>::size_type CowVector<T, Alloc>::insert(const_iterator pos, const value_type &val)
+{
+    size_type n = indexOf(pos);
+    CowVector old(alloc());
+    vector_type &vec = make_unique(old);
+    vec.insert(vec.begin() + n, val);
+    return n;
+}
+
+template <typename T, typename Alloc>
+typename CowVector<T, Alloc>::size_type CowVector<T, Alloc>::erase(const_iterator first, const_iterator last)
+{
+    size_type n = indexOf(first), count = last - first;
+    vector_type &vec = make_unique();
+    vec.erase(vec.begin() + n, vec.begin() + n + count);
+    return n;
+}
+
+template <typename T, typename Alloc>
+void swap(CowVector<T, Alloc> &lhs, CowVector<T, Alloc> &rhs) noexcept
+{   lhs.swap(rhs);  }
+
+#endif  /* COWVECTOR_HPP */
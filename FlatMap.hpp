@@ -0,0 +1,335 @@
+#ifndef FLATMAP_HPP
+#define FLATMAP_HPP
+
+#include "Vector.hpp"
+#include <functional>
+
+//有序Vector上的关联容器：元素按键排好序连续存放，查找是对数组的二分，没有结点分配和指针追逐
+//单个插入、删除需要移动后面的元素，是O(n)；批量插入先追加到末尾，排序后和原有元素合并一次
+//适合构造后很少修改、主要用来查找的中小规模的表
+namespace flat_detail
+{
+
+struct Identity
+{
+    template <typename T>
+    const T &operator()(const T &v) const { return v; }
+};
+
+struct First
+{
+    template <typename Pair>
+    const typename Pair::first_type &operator()(const Pair &p) const { return p.first; }
+};
+
+//无分支的lower_bound：每一步只根据比较结果选择下一段的起点，编译为条件传送，
+//循环次数只和n有关，不会因为分支预测失败而停顿
+template <typename T, typename Key, typename KeyOf, typename Compare>
+T *lowerBound(T *base, size_t n, const Key &key, KeyOf key_of, Compare comp)
+{
+    if(n == 0)
+        return base;
+    while(n > 1)
+    {
+        size_t half = n / 2;
+        base = comp(key_of(base[half]), key) ? base + half : base;
+        n -= half;
+    }
+    return base + comp(key_of(*base), key);
+}
+
+}
+
+//FlatSet和FlatMap的公共部分，KeyOf从元素中取出键
+template <typename Value, typename Key, typename KeyOf, typename Compare, typename Alloc>
+class FlatTree
+{
+    static const bool kIsSet = std::is_same<KeyOf, flat_detail::Identity>::value;
+
+public:
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef Compare key_compare;
+    typedef Vector<Value, Alloc> container_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef const Value *const_iterator;
+    //集合的元素就是键，不能通过迭代器修改
+    typedef typename std::conditional<kIsSet, const Value *, Value *>::type iterator;
+
+    FlatTree() { }
+    explicit FlatTree(const Compare &comp) :comp_(comp) { }
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    FlatTree(In first, In last, const Compare &comp = Compare())
+        :comp_(comp)
+    { insert(first, last); }
+    //接管seq的元素，排序并去掉重复的键，相等的键保留最先出现的
+    explicit FlatTree(container_type &&seq, const Compare &comp = Compare())
+        :data_(std::move(seq)), comp_(comp)
+    { normalize(0); }
+
+    iterator begin() { return data_.begin(); }
+    iterator end() { return data_.end(); }
+    const_iterator begin() const { return data_.begin(); }
+    const_iterator end() const { return data_.end(); }
+
+    bool empty() const { return data_.empty(); }
+    size_type size() const { return data_.size(); }
+    size_type capacity() const { return data_.capacity(); }
+    void reserve(size_type n) { data_.reserve(n); }
+    void clear() { data_.clear(); }
+    key_compare key_comp() const { return comp_; }
+    //按键排好序的元素
+    const container_type &sequence() const { return data_; }
+
+    iterator lower_bound(const key_type &key)
+    {   return flat_detail::lowerBound(data_.begin(), data_.size(), key, KeyOf(), comp_);   }
+    const_iterator lower_bound(const key_type &key) const
+    {   return flat_detail::lowerBound(data_.begin(), data_.size(), key, KeyOf(), comp_);   }
+    iterator upper_bound(const key_type &key)
+    {   return std::upper_bound(begin(), end(), key, upperComp());  }
+    const_iterator upper_bound(const key_type &key) const
+    {   return std::upper_bound(begin(), end(), key, upperComp());  }
+    std::pair<iterator, iterator> equal_range(const key_type &key)
+    {
+        iterator it = lower_bound(key);
+        return std::make_pair(it, it + matches(it, key));
+    }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const
+    {
+        const_iterator it = lower_bound(key);
+        return std::make_pair(it, it + matches(it, key));
+    }
+    iterator find(const key_type &key)
+    {
+        iterator it = lower_bound(key);
+        return matches(it, key) ? it : end();
+    }
+    const_iterator find(const key_type &key) const
+    {
+        const_iterator it = lower_bound(key);
+        return matches(it, key) ? it : end();
+    }
+    size_type count(const key_type &key) const { return matches(lower_bound(key), key); }
+    bool contains(const key_type &key) const { return count(key) != 0; }
+
+    //键已经存在时不插入，返回已有的元素
+    std::pair<iterator, bool> insert(const value_type &v) { return insertUnique(v); }
+    std::pair<iterator, bool> insert(value_type &&v) { return insertUnique(std::move(v)); }
+    //批量插入：追加后排序新的部分，再和原有元素合并一次；已有的键保持不变
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    void insert(In first, In last);
+
+    size_type erase(const key_type &key);
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    void swap(FlatTree &other)
+    {
+        data_.swap(other.data_);
+        std::swap(comp_, other.comp_);
+    }
+
+    //比较直接使用Vector的运算符
+    friend bool operator==(const FlatTree &lhs, const FlatTree &rhs) { return lhs.data_ == rhs.data_; }
+    friend bool operator!=(const FlatTree &lhs, const FlatTree &rhs) { return lhs.data_ != rhs.data_; }
+    friend bool operator<(const FlatTree &lhs, const FlatTree &rhs) { return lhs.data_ < rhs.data_; }
+    friend bool operator<=(const FlatTree &lhs, const FlatTree &rhs) { return lhs.data_ <= rhs.data_; }
+    friend bool operator>(const FlatTree &lhs, const FlatTree &rhs) { return lhs.data_ > rhs.data_; }
+    friend bool operator>=(const FlatTree &lhs, const FlatTree &rhs) { return lhs.data_ >= rhs.data_; }
+
+protected:
+    //it是lower_bound(key)的结果，键相等时返回1
+    size_type matches(const_iterator it, const key_type &key) const
+    {   return it != end() && !comp_(key, KeyOf()(*it));    }
+
+    template <typename V>
+    std::pair<iterator, bool> insertUnique(V &&v);
+
+    container_type data_;
+    Compare comp_;
+
+private:
+    struct ValueComp
+    {
+        Compare comp;
+        bool operator()(const value_type &a, const value_type &b) const
+        {   return comp(KeyOf()(a), KeyOf()(b));    }
+    };
+    struct UpperComp
+    {
+        Compare comp;
+        bool operator()(const key_type &key, const value_type &v) const
+        {   return comp(key, KeyOf()(v));   }
+    };
+    struct Equivalent
+    {
+        Compare comp;
+        bool operator()(const value_type &a, const value_type &b) const
+        {   return !comp(KeyOf()(a), KeyOf()(b)) && !comp(KeyOf()(b), KeyOf()(a));  }
+    };
+
+    ValueComp valueComp() const { ValueComp c = { comp_ }; return c; }
+    UpperComp upperComp() const { UpperComp c = { comp_ }; return c; }
+
+    //[0, sorted)已经有序且没有重复，把后面的元素排序、合并并去重
+    void normalize(size_type sorted);
+};
+
+template <typename Value, typename Key, typename KeyOf, typename Compare, typename Alloc>
+template <typename V>
+std::pair<typename FlatTree<Value, Key, KeyOf, Compare, Alloc>::iterator, bool>
+FlatTree<Value, Key, KeyOf, Compare, Alloc>::insertUnique(V &&v)
+{
+    iterator it = lower_bound(KeyOf()(v));
+    if(matches(it, KeyOf()(v)))
+        return std::make_pair(it, false);
+    typename container_type::iterator pos = data_.begin() + (it - begin());
+    return std::make_pair(iterator(data_.insert(pos, std::forward<V>(v))), true);
+}
+
+template <typename Value, typename Key, typename KeyOf, typename Compare, typename Alloc>
+template <typename In, typename>
+void FlatTree<Value, Key, KeyOf, Compare, Alloc>::insert(In first, In last)
+{
+    size_type sorted = data_.size();
+    data_.insert(data_.end(), first, last);
+    normalize(sorted);
+}
+
+template <typename Value, typename Key, typename KeyOf, typename Compare, typename Alloc>
+void FlatTree<Value, Key, KeyOf, Compare, Alloc>::normalize(size_type sorted)
+{
+    typename container_type::iterator first = data_.begin(), mid = first + sorted, last = data_.end();
+    if(mid == last)
+        return;
+    //稳定排序和合并保证相等的键中原有的、先出现的排在前面，unique保留的就是它
+    std::stable_sort(mid, last, valueComp());
+    //新的键都不小于原有的最大键时只需要检查接缝处，否则合并后重复的键可能出现在任何位置
+    typename container_type::iterator from = first;
+    if(mid != first)
+    {
+        if(valueComp()(*mid, mid[-1]))
+            std::inplace_merge(first, mid, last, valueComp());
+        else
+            from = mid - 1;
+    }
+    Equivalent eq = { comp_ };
+    data_.erase(std::unique(from, last, eq), last);
+}
+
+template <typename Value, typename Key, typename KeyOf, typename Compare, typename Alloc>
+typename FlatTree<Value, Key, KeyOf, Compare, Alloc>::size_type
+FlatTree<Value, Key, KeyOf, Compare, Alloc>::erase(const key_type &key)
+{
+    const_iterator it = lower_bound(key);
+    if(!matches(it, key))
+        return 0;
+    erase(it);
+    return 1;
+}
+
+template <typename Value, typename Key, typename KeyOf, typename Compare, typename Alloc>
+typename FlatTree<Value, Key, KeyOf, Compare, Alloc>::iterator
+FlatTree<Value, Key, KeyOf, Compare, Alloc>::erase(const_iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template <typename Value, typename Key, typename KeyOf, typename Compare, typename Alloc>
+typename FlatTree<Value, Key, KeyOf, Compare, Alloc>::iterator
+FlatTree<Value, Key, KeyOf, Compare, Alloc>::erase(const_iterator first, const_iterator last)
+{
+    typename container_type::iterator base = data_.begin();
+    return data_.erase(base + (first - base), base + (last - base));
+}
+
+//有序的集合
+template <typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key> >
+class FlatSet : public FlatTree<Key, Key, flat_detail::Identity, Compare, Alloc>
+{
+    typedef FlatTree<Key, Key, flat_detail::Identity, Compare, Alloc> Base;
+
+public:
+    FlatSet() { }
+    explicit FlatSet(const Compare &comp) :Base(comp) { }
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    FlatSet(In first, In last, const Compare &comp = Compare()) :Base(first, last, comp) { }
+    explicit FlatSet(typename Base::container_type &&seq, const Compare &comp = Compare())
+        :Base(std::move(seq), comp) { }
+};
+
+//有序的映射，元素是std::pair<Key, T>：不要通过迭代器修改键
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<Key, T> > >
+class FlatMap : public FlatTree<std::pair<Key, T>, Key, flat_detail::First, Compare, Alloc>
+{
+    typedef FlatTree<std::pair<Key, T>, Key, flat_detail::First, Compare, Alloc> Base;
+
+public:
+    typedef T mapped_type;
+    typedef typename Base::iterator iterator;
+    typedef typename Base::key_type key_type;
+    typedef typename Base::value_type value_type;
+
+    FlatMap() { }
+    explicit FlatMap(const Compare &comp) :Base(comp) { }
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    FlatMap(In first, In last, const Compare &comp = Compare()) :Base(first, last, comp) { }
+    explicit FlatMap(typename Base::container_type &&seq, const Compare &comp = Compare())
+        :Base(std::move(seq), comp) { }
+
+    //键不存在时插入值初始化的元素，已经存在时不构造T
+    T &operator[] (const key_type &key);
+    T &at(const key_type &key);
+    const T &at(const key_type &key) const;
+
+    //键已经存在时覆盖它的值
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj);
+};
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+T &FlatMap<Key, T, Compare, Alloc>::operator[] (const key_type &key)
+{
+    iterator it = this->lower_bound(key);
+    if(this->matches(it, key))
+        return it->second;
+    typename Base::container_type::iterator pos = this->data_.begin() + (it - this->begin());
+    return this->data_.insert(pos, value_type(key, T()))->second;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+T &FlatMap<Key, T, Compare, Alloc>::at(const key_type &key)
+{
+    iterator it = this->find(key);
+    if(it == this->end())
+        throw std::out_of_range("FlatMap::at");
+    return it->second;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+const T &FlatMap<Key, T, Compare, Alloc>::at(const key_type &key) const
+{
+    typename Base::const_iterator it = this->find(key);
+    if(it == this->end())
+        throw std::out_of_range("FlatMap::at");
+    return it->second;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename M>
+std::pair<typename FlatMap<Key, T, Compare, Alloc>::iterator, bool>
+FlatMap<Key, T, Compare, Alloc>::insert_or_assign(const key_type &key, M &&obj)
+{
+    iterator it = this->lower_bound(key);
+    if(this->matches(it, key))
+    {
+        it->second = std::forward<M>(obj);
+        return std::make_pair(it, false);
+    }
+    typename Base::container_type::iterator pos = this->data_.begin() + (it - this->begin());
+    return std::make_pair(iterator(this->data_.insert(pos, value_type(key, std::forward<M>(obj)))), true);
+}
+
+#endif  /* FLATMAP_HPP */
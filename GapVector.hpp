@@ -0,0 +1,434 @@
+#ifndef GAPVECTOR_HPP
+#define GAPVECTOR_HPP
+
+#include "Vector.hpp"
+
+//带间隙的缓冲区：元素存放在[0, gap_begin_)和[gap_end_, cap_)两段中，中间是未构造的间隙
+//插入和删除发生在间隙处，间隙跟着上一次编辑的位置走，
+//所以在光标附近连续编辑的代价只和光标移动的距离有关，与元素总数无关
+//内存由Alloc分配，容量按Growth增长，能按字节搬迁的元素移动间隙时直接memmove
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = GrowDouble>
+class GapVector : private VectorAllocHolder<Alloc>
+{
+    typedef VectorAllocHolder<Alloc> AllocHolder;
+    typedef std::allocator_traits<Alloc> alloc_traits;
+
+    //下标n在间隙之前时就是物理位置，否则要跳过间隙
+    template <typename Ref, typename Ptr>
+    class basic_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+
+        basic_iterator() :base_(NULL), gap_begin_(0), gap_len_(0), n_(0) { }
+        basic_iterator(Ptr base, size_t gap_begin, size_t gap_len, size_t n)
+            :base_(base), gap_begin_(gap_begin), gap_len_(gap_len), n_(n) { }
+        //提供从iterator到const_iterator的转换
+        template <typename R, typename P>
+        basic_iterator(const basic_iterator<R, P> &it)
+            :base_(it.base_), gap_begin_(it.gap_begin_), gap_len_(it.gap_len_), n_(it.n_) { }
+
+        reference operator*() const
+        {   return base_[n_ < gap_begin_ ? n_ : n_ + gap_len_];  }
+        pointer operator->() const
+        {   return &**this; }
+        reference operator[](difference_type d) const
+        {   return *(*this + d);    }
+
+        basic_iterator &operator++() { ++n_; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp(*this); ++n_; return temp; }
+        basic_iterator &operator--() { --n_; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp(*this); --n_; return temp; }
+        basic_iterator &operator+=(difference_type d) { n_ += d; return *this; }
+        basic_iterator &operator-=(difference_type d) { n_ -= d; return *this; }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type d)
+        {   return it += d; }
+        friend basic_iterator operator+(difference_type d, basic_iterator it)
+        {   return it += d; }
+        friend basic_iterator operator-(basic_iterator it, difference_type d)
+        {   return it -= d; }
+        friend difference_type operator-(const basic_iterator &i, const basic_iterator &j)
+        {   return static_cast<difference_type>(i.n_) - static_cast<difference_type>(j.n_);    }
+
+        friend bool operator==(const basic_iterator &i, const basic_iterator &j) { return i.n_ == j.n_; }
+        friend bool operator!=(const basic_iterator &i, const basic_iterator &j) { return i.n_ != j.n_; }
+        friend bool operator<(const basic_iterator &i, const basic_iterator &j) { return i.n_ < j.n_; }
+        friend bool operator>(const basic_iterator &i, const basic_iterator &j) { return i.n_ > j.n_; }
+        friend bool operator<=(const basic_iterator &i, const basic_iterator &j) { return i.n_ <= j.n_; }
+        friend bool operator>=(const basic_iterator &i, const basic_iterator &j) { return i.n_ >= j.n_; }
+
+        size_t index() const { return n_; }
+
+    private:
+        template <typename R, typename P>
+        friend class basic_iterator;
+
+        Ptr base_; //缓冲区的起始位置
+        size_t gap_begin_;
+        size_t gap_len_;
+        size_t n_; //逻辑下标
+    };
+
+public:
+    typedef T value_type;
+    typedef basic_iterator<T &, T *> iterator;
+    typedef basic_iterator<const T &, const T *> const_iterator;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef Alloc allocator_type;
+
+    explicit GapVector(const allocator_type &a = allocator_type())
+        :AllocHolder(a), data_(NULL), gap_begin_(0), gap_end_(0), cap_(0) { }
+    explicit GapVector(size_type n, const value_type &val = value_type(),
+                       const allocator_type &a = allocator_type())
+        :AllocHolder(a), data_(NULL), gap_begin_(0), gap_end_(0), cap_(0)
+    {   insert(end(), n, val);  }
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    GapVector(In i, In j, const allocator_type &a = allocator_type())
+        :AllocHolder(a), data_(NULL), gap_begin_(0), gap_end_(0), cap_(0)
+    {   insert(end(), i, j);    }
+
+    GapVector(const GapVector &other)
+        :AllocHolder(alloc_traits::select_on_container_copy_construction(other.alloc())),
+         data_(NULL), gap_begin_(0), gap_end_(0), cap_(0)
+    {
+        reserve(other.size());
+        insert(end(), other.begin(), other.end());
+    }
+    GapVector(GapVector &&other) noexcept
+        :AllocHolder(std::move(other.alloc())), data_(other.data_), gap_begin_(other.gap_begin_),
+         gap_end_(other.gap_end_), cap_(other.cap_)
+    {
+        other.data_ = NULL;
+        other.gap_begin_ = other.gap_end_ = other.cap_ = 0;
+    }
+    GapVector &operator=(GapVector other)
+    {
+        swap(other);
+        return *this;
+    }
+    ~GapVector() { uncreate(); }
+
+    void swap(GapVector &other)
+    {
+        //与Vector相同：分配器不随swap传播且不相等时不能交换内存，只能交换元素
+        if(!alloc_traits::propagate_on_container_swap::value && alloc() != other.alloc())
+        {
+            swapElements(other);
+            return;
+        }
+        using std::swap;
+        if(alloc_traits::propagate_on_container_swap::value)
+            swap(alloc(), other.alloc());
+        swap(data_, other.data_);
+        swap(gap_begin_, other.gap_begin_);
+        swap(gap_end_, other.gap_end_);
+        swap(cap_, other.cap_);
+    }
+
+    reference operator[] (size_type n) { return data_[physical(n)]; }
+    const_reference operator[] (size_type n) const { return data_[physical(n)]; }
+    reference front() { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+    const_reference front() const { return (*this)[0]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    iterator begin() { return iterator(data_, gap_begin_, gapLength(), 0); }
+    iterator end() { return iterator(data_, gap_begin_, gapLength(), size()); }
+    const_iterator begin() const { return const_iterator(data_, gap_begin_, gapLength(), 0); }
+    const_iterator end() const { return const_iterator(data_, gap_begin_, gapLength(), size()); }
+
+    bool empty() const { return size() == 0; }
+    size_type size() const { return cap_ - gapLength(); }
+    size_type capacity() const { return cap_; }
+    size_type max_size() const
+    {
+        return std::min<size_type>(alloc_traits::max_size(alloc()),
+            std::numeric_limits<difference_type>::max() / sizeof(T));
+    }
+    //间隙所在的逻辑位置，也就是上一次编辑的位置
+    size_type gap_position() const { return gap_begin_; }
+
+    void push_back(const T &t) { emplace(end(), t); }
+    void push_back(T &&t) { emplace(end(), std::move(t)); }
+    void pop_back() { erase(end() - 1); }
+
+    //迭代器在任何插入、删除之后失效
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args&&... args);
+    iterator insert(const_iterator position, const value_type &val)
+    {   return emplace(position, val);  }
+    iterator insert(const_iterator position, value_type &&val)
+    {   return emplace(position, std::move(val));   }
+    iterator insert(const_iterator position, size_type n, const value_type &val);
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    iterator insert(const_iterator position, In first, In last);
+
+    iterator erase(const_iterator position)
+    {   return erase(position, position + 1);  }
+    iterator erase(const_iterator first, const_iterator last);
+    void clear() { erase(begin(), end()); }
+
+    void reserve(size_type n);
+
+    allocator_type get_allocator() const { return alloc(); }
+
+    friend bool operator==(const GapVector &lhs, const GapVector &rhs)
+    {   return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());    }
+    friend bool operator!=(const GapVector &lhs, const GapVector &rhs)
+    {   return !(lhs == rhs);   }
+    friend bool operator<(const GapVector &lhs, const GapVector &rhs)
+    {   return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());  }
+
+private:
+    Alloc &alloc() { return AllocHolder::get(); }
+    const Alloc &alloc() const { return AllocHolder::get(); }
+
+    size_type gapLength() const { return gap_end_ - gap_begin_; }
+    size_type physical(size_type n) const { return n < gap_begin_ ? n : n + gapLength(); }
+
+    //把间隙移到逻辑位置pos，每搬一个元素都更新间隙，中途抛出异常时容器仍然有效
+    void moveGap(size_type pos);
+    //保证间隙至少能放下n个元素，间隙的位置不变
+    void ensureGap(size_type n);
+    //把一个元素从src搬到未初始化的dest
+    void relocateOne(T *src, T *dest)
+    {
+        alloc_traits::construct(alloc(), dest, std::move(*src));
+        alloc_traits::destroy(alloc(), src);
+    }
+    void swapElements(GapVector &other);
+    template <typename In>
+    void insertRange(size_type pos, In first, In last, std::input_iterator_tag);
+    template <typename In>
+    void insertRange(size_type pos, In first, In last, std::forward_iterator_tag);
+    void uncreate();
+
+    T *data_;
+    size_type gap_begin_; //间隙的第一个位置
+    size_type gap_end_; //间隙之后的第一个元素
+    size_type cap_;
+};
+
+template <typename T, typename Alloc, typename Growth>
+void GapVector<T, Alloc, Growth>::moveGap(size_type pos)
+{
+    if(pos == gap_begin_)
+        return;
+    size_type len = gapLength();
+    if(len == 0)
+    {
+        //没有间隙，移动只是改变下标
+        gap_begin_ = gap_end_ = pos;
+        return;
+    }
+
+    if(is_trivially_relocatable<T>::value)
+    {
+        if(pos < gap_begin_) //[pos, gap_begin_)搬到间隙的后部
+            memmove(static_cast<void *>(data_ + pos + len), static_cast<const void *>(data_ + pos),
+                    (gap_begin_ - pos) * sizeof(T));
+        else //间隙后面的pos - gap_begin_个元素搬到间隙的前部
+            memmove(static_cast<void *>(data_ + gap_begin_), static_cast<const void *>(data_ + gap_end_),
+                    (pos - gap_begin_) * sizeof(T));
+        gap_begin_ = pos;
+        gap_end_ = pos + len;
+        return;
+    }
+
+    while(gap_begin_ > pos)
+    {
+        relocateOne(data_ + gap_begin_ - 1, data_ + gap_end_ - 1);
+        --gap_begin_;
+        --gap_end_;
+    }
+    while(gap_begin_ < pos)
+    {
+        relocateOne(data_ + gap_end_, data_ + gap_begin_);
+        ++gap_begin_;
+        ++gap_end_;
+    }
+}
+
+template <typename T, typename Alloc, typename Growth>
+void GapVector<T, Alloc, Growth>::ensureGap(size_type n)
+{
+    if(gapLength() >= n)
+        return;
+    size_type len = size();
+    if(n > max_size() - len)
+        throw std::length_error("GapVector");
+    reserve(Growth::next(cap_, len + n, sizeof(T), max_size()));
+}
+
+template <typename T, typename Alloc, typename Growth>
+void GapVector<T, Alloc, Growth>::reserve(size_type n)
+{
+    if(n <= cap_)
+        return;
+    if(n > max_size())
+        throw std::length_error("GapVector::reserve");
+
+    //前一段放在开头，后一段放在末尾，中间的间隙变大
+    T *new_data = alloc_traits::allocate(alloc(), n);
+    size_type tail = cap_ - gap_end_;
+    size_type new_gap_end = n - tail;
+    if(is_trivially_relocatable<T>::value)
+    {
+        if(data_ != NULL)
+        {
+            memcpy(static_cast<void *>(new_data), static_cast<const void *>(data_), gap_begin_ * sizeof(T));
+            memcpy(static_cast<void *>(new_data + new_gap_end), static_cast<const void *>(data_ + gap_end_),
+                   tail * sizeof(T));
+        }
+    }
+    else
+    {
+        T *head_end = new_data;
+        try
+        {
+            head_end = uninitializedMoveIfNoexcept(data_, data_ + gap_begin_, new_data);
+            uninitializedMoveIfNoexcept(data_ + gap_end_, data_ + cap_, new_data + new_gap_end);
+        }
+        catch(...)
+        {
+            for(T *p = new_data; p != head_end; ++p)
+                alloc_traits::destroy(alloc(), p);
+            alloc_traits::deallocate(alloc(), new_data, n);
+            throw;
+        }
+        for(size_type ix = 0; ix != gap_begin_; ++ix)
+            alloc_traits::destroy(alloc(), data_ + ix);
+        for(size_type ix = gap_end_; ix != cap_; ++ix)
+            alloc_traits::destroy(alloc(), data_ + ix);
+    }
+    if(data_ != NULL)
+        alloc_traits::deallocate(alloc(), data_, cap_);
+
+    data_ = new_data;
+    gap_end_ = new_gap_end;
+    cap_ = n;
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename... Args>
+typename GapVector<T, Alloc, Growth>::iterator
+GapVector<T, Alloc, Growth>::emplace(const_iterator position, Args&&... args)
+{
+    size_type pos = position.index();
+    value_type tmp(std::forward<Args>(args)...); //args可能引用容器中的元素
+    ensureGap(1);
+    moveGap(pos);
+    alloc_traits::construct(alloc(), data_ + gap_begin_, std::move(tmp));
+    ++gap_begin_;
+    return begin() + pos;
+}
+
+template <typename T, typename Alloc, typename Growth>
+typename GapVector<T, Alloc, Growth>::iterator
+GapVector<T, Alloc, Growth>::insert(const_iterator position, size_type n, const value_type &val)
+{
+    size_type pos = position.index();
+    const value_type tmp(val);
+    ensureGap(n);
+    moveGap(pos);
+    for(size_type ix = 0; ix != n; ++ix)
+    {
+        alloc_traits::construct(alloc(), data_ + gap_begin_, tmp);
+        ++gap_begin_;
+    }
+    return begin() + pos;
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename In, typename>
+typename GapVector<T, Alloc, Growth>::iterator
+GapVector<T, Alloc, Growth>::insert(const_iterator position, In first, In last)
+{
+    size_type pos = position.index();
+    insertRange(pos, first, last, typename std::iterator_traits<In>::iterator_category());
+    return begin() + pos;
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename In>
+void GapVector<T, Alloc, Growth>::insertRange(size_type pos, In first, In last, std::input_iterator_tag)
+{
+    //个数未知：间隙移到pos之后，逐个放进间隙，每次都是O(1)
+    for(size_type ix = pos; first != last; ++first, ++ix)
+        emplace(begin() + ix, *first);
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename In>
+void GapVector<T, Alloc, Growth>::insertRange(size_type pos, In first, In last, std::forward_iterator_tag)
+{
+    //先一次把间隙扩大到能放下所有元素，再依次构造在间隙里，中途抛出异常时已经放入的元素保留
+    ensureGap(std::distance(first, last));
+    moveGap(pos);
+    for(; first != last; ++first)
+    {
+        alloc_traits::construct(alloc(), data_ + gap_begin_, *first);
+        ++gap_begin_;
+    }
+}
+
+template <typename T, typename Alloc, typename Growth>
+typename GapVector<T, Alloc, Growth>::iterator
+GapVector<T, Alloc, Growth>::erase(const_iterator first, const_iterator last)
+{
+    size_type pos = first.index(), n = last - first;
+    if(n == 0)
+        return begin() + pos;
+    if(pos + n <= gap_begin_)
+    {
+        //被删除的区间在间隙前面：间隙移到区间末尾，从后往前并入间隙
+        moveGap(pos + n);
+        while(gap_begin_ != pos)
+            alloc_traits::destroy(alloc(), data_ + --gap_begin_);
+    }
+    else
+    {
+        moveGap(pos);
+        for(size_type ix = 0; ix != n; ++ix)
+            alloc_traits::destroy(alloc(), data_ + gap_end_++);
+    }
+    return begin() + pos;
+}
+
+template <typename T, typename Alloc, typename Growth>
+void GapVector<T, Alloc, Growth>::swapElements(GapVector &other)
+{
+    GapVector &shorter = size() < other.size() ? *this : other;
+    GapVector &longer = size() < other.size() ? other : *this;
+    size_type n = shorter.size();
+    std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+    shorter.insert(shorter.end(), std::make_move_iterator(longer.begin() + n),
+                   std::make_move_iterator(longer.end()));
+    longer.erase(longer.begin() + n, longer.end());
+}
+
+template <typename T, typename Alloc, typename Growth>
+void GapVector<T, Alloc, Growth>::uncreate()
+{
+    if(data_ == NULL)
+        return;
+    for(size_type ix = 0; ix != gap_begin_; ++ix)
+        alloc_traits::destroy(alloc(), data_ + ix);
+    for(size_type ix = gap_end_; ix != cap_; ++ix)
+        alloc_traits::destroy(alloc(), data_ + ix);
+    alloc_traits::deallocate(alloc(), data_, cap_);
+    data_ = NULL;
+    gap_begin_ = gap_end_ = cap_ = 0;
+}
+
+#endif  /* GAPVECTOR_HPP */
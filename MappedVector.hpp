@@ -0,0 +1,282 @@
+#ifndef MAPPEDVECTOR_HPP
+#define MAPPEDVECTOR_HPP
+
+#include "Vector.hpp"
+#include "Allocator.hpp"
+#include <string>
+#include <stdexcept>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//映射到内存的文件：第一页是文件头，后面是元素数组
+//整个文件一次映射，扩容时ftruncate加mremap，数据不经过用户态拷贝
+class MappedFile
+{
+public:
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t elem_size;
+        uint64_t count; //元素数量，sync()和析构时写入
+    };
+    static const size_t kHeaderSize = 4096;
+
+    MappedFile(const char *path, size_t elem_size, bool readonly);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    Header *header() const { return reinterpret_cast<Header *>(base_); }
+    char *data() const { return base_ + kHeaderSize; }
+    size_t capacityBytes() const { return mapped_ - kHeaderSize; }
+    bool readonly() const { return readonly_; }
+    //数据区是否已经交给了一个Vector，同一时刻只能有一个
+    bool inUse() const { return in_use_; }
+    void setInUse(bool in_use) { in_use_ = in_use; }
+
+    //把数据区调整为bytes字节，返回新的数据区地址
+    char *resize(size_t bytes);
+    //把脏页写回文件，wait为false时只发起写回
+    void sync(bool wait);
+
+private:
+    static void fail(const std::string &what)
+    {   throw std::runtime_error("MappedFile: " + what + ": " + strerror(errno));   }
+
+    std::string path_;
+    int fd_;
+    char *base_; //映射的起始地址
+    size_t mapped_; //映射的字节数，等于文件大小
+    bool readonly_;
+    bool in_use_;
+};
+
+inline MappedFile::MappedFile(const char *path, size_t elem_size, bool readonly)
+    :path_(path), fd_(-1), base_(NULL), mapped_(0), readonly_(readonly), in_use_(false)
+{
+    fd_ = ::open(path, readonly ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+    if(fd_ < 0)
+        fail("open " + path_);
+
+    struct stat st;
+    if(fstat(fd_, &st) < 0)
+    {
+        ::close(fd_);
+        fail("fstat " + path_);
+    }
+
+    bool fresh = (st.st_size == 0);
+    if(fresh && readonly)
+    {
+        ::close(fd_);
+        throw std::runtime_error("MappedFile: " + path_ + " is empty");
+    }
+    if(fresh && ftruncate(fd_, kHeaderSize) < 0)
+    {
+        ::close(fd_);
+        fail("ftruncate " + path_);
+    }
+    mapped_ = fresh ? kHeaderSize : static_cast<size_t>(st.st_size);
+    if(mapped_ < kHeaderSize)
+    {
+        ::close(fd_);
+        throw std::runtime_error("MappedFile: " + path_ + " is truncated");
+    }
+
+    void *p = mmap(NULL, mapped_, readonly ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, fd_, 0);
+    if(p == MAP_FAILED)
+    {
+        ::close(fd_);
+        fail("mmap " + path_);
+    }
+    base_ = static_cast<char *>(p);
+
+    Header *h = header();
+    if(fresh)
+    {
+        memcpy(h->magic, "VECMMAP", 8);
+        h->version = 1;
+        h->elem_size = static_cast<uint32_t>(elem_size);
+        h->count = 0;
+    }
+    else if(memcmp(h->magic, "VECMMAP", 8) != 0 || h->elem_size != elem_size
+            || h->count > capacityBytes() / elem_size)
+    {
+        munmap(base_, mapped_);
+        ::close(fd_);
+        throw std::runtime_error("MappedFile: " + path_ + " has a bad header");
+    }
+}
+
+inline MappedFile::~MappedFile()
+{
+    munmap(base_, mapped_);
+    ::close(fd_);
+}
+
+inline char *MappedFile::resize(size_t bytes)
+{
+    if(readonly_)
+        throw std::runtime_error("MappedFile: " + path_ + " is read-only");
+
+    size_t new_size = kHeaderSize + bytes;
+    if(new_size > mapped_ && ftruncate(fd_, new_size) < 0)
+        fail("ftruncate " + path_);
+    void *p = mremap(base_, mapped_, new_size, MREMAP_MAYMOVE);
+    if(p == MAP_FAILED)
+        fail("mremap " + path_);
+    if(new_size < mapped_ && ftruncate(fd_, new_size) < 0)
+        fail("ftruncate " + path_);
+    base_ = static_cast<char *>(p);
+    mapped_ = new_size;
+    return data();
+}
+
+inline void MappedFile::sync(bool wait)
+{
+    if(msync(base_, mapped_, wait ? MS_SYNC : MS_ASYNC) < 0)
+        fail("msync " + path_);
+}
+
+//把Vector的内存放在MappedFile里的分配器
+//整个文件只有一块数据区：allocate和reallocate都是调整它的大小，
+//旧的内存还在使用时再次allocate会得到同一块数据区，所以同一时刻只允许一块，否则抛出logic_error；
+//deallocate只是归还数据区，数据区随MappedFile一起解除映射
+//没有关联文件的分配器从堆上分配，拷贝构造的容器用它，不和原来的容器共用文件
+template <typename T>
+class MmapAllocator
+{
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <typename U>
+    struct rebind { typedef MmapAllocator<U> other; };
+
+    explicit MmapAllocator(MappedFile *file = NULL) :file_(file) { }
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U> &other) :file_(other.file()) { }
+
+    //只读文件不能调整大小，抛出runtime_error
+    pointer allocate(size_type n)
+    {
+        if(file_ == NULL)
+            return MallocAllocator<T>().allocate(n);
+        if(file_->inUse())
+            throw std::logic_error("MmapAllocator: mapped file already holds a live buffer");
+        pointer p = resize(n);
+        file_->setInUse(true);
+        return p;
+    }
+    void deallocate(pointer p, size_type n)
+    {
+        if(file_ == NULL)
+            MallocAllocator<T>().deallocate(p, n);
+        else if(p != NULL) //移动后留下的空容器也会调用，不能影响接管了数据区的容器
+            file_->setInUse(false);
+    }
+    //p是文件中正在使用的数据区，原地调整大小
+    pointer reallocate(pointer p, size_type old_n, size_type new_n)
+    {
+        if(file_ == NULL)
+            return MallocAllocator<T>().reallocate(p, old_n, new_n);
+        if(p == NULL)
+            return allocate(new_n);
+        return resize(new_n);
+    }
+
+    //拷贝出的容器不能和原来的容器共用一个文件
+    MmapAllocator select_on_container_copy_construction() const { return MmapAllocator(); }
+
+    MappedFile *file() const { return file_; }
+
+private:
+    pointer resize(size_type n)
+    {
+        if(file_->readonly())
+            throw std::runtime_error("MmapAllocator: mapped file is read-only");
+        return reinterpret_cast<pointer>(file_->resize(n * sizeof(T)));
+    }
+
+    MappedFile *file_;
+};
+
+template <typename T, typename U>
+bool operator==(const MmapAllocator<T> &lhs, const MmapAllocator<U> &rhs)
+{   return lhs.file() == rhs.file();  }
+template <typename T, typename U>
+bool operator!=(const MmapAllocator<T> &lhs, const MmapAllocator<U> &rhs)
+{   return lhs.file() != rhs.file();  }
+
+//MappedFile必须比Vector先构造、后析构，所以放在前一个基类里
+struct MappedFileHolder
+{
+    MappedFileHolder(MappedFile *file) :file_(file) { }
+    std::unique_ptr<MappedFile> file_;
+};
+
+//元素保存在文件里的Vector，接口、迭代器和比较运算都来自Vector
+//扩容通过ftruncate和mremap完成，只支持可平凡拷贝的类型
+//一个文件只有一块数据区，MappedVector不能拷贝；把它拷贝成Vector时新容器的元素在堆上
+template <typename T, typename Growth = GrowDouble>
+class MappedVector : private MappedFileHolder, public Vector<T, MmapAllocator<T>, Growth>
+{
+    typedef Vector<T, MmapAllocator<T>, Growth> Base;
+    static_assert(std::is_trivially_copyable<T>::value, "MappedVector requires trivially copyable T");
+public:
+    //打开或创建path，可以读写
+    explicit MappedVector(const char *path)
+        :MappedFileHolder(new MappedFile(path, sizeof(T), false)),
+         Base(MmapAllocator<T>(file_.get()))
+    {   attach();   }
+
+    MappedVector(MappedVector &&other) = default;
+    MappedVector &operator=(MappedVector &&other) = delete;
+    ~MappedVector()
+    {
+        if(file_ && !file_->readonly())
+            file_->header()->count = this->size();
+    }
+
+    //只读打开：只建立映射，页面在第一次访问时才读入
+    //返回的对象只能读：容量等于元素个数，push_back等需要分配内存的操作抛出runtime_error；
+    //映射是PROT_READ的，通过operator[]等写入元素会触发SIGSEGV
+    static MappedVector open_readonly(const char *path)
+    {   return MappedVector(new MappedFile(path, sizeof(T), true));  }
+
+    //持久化点：写入元素数量并把脏页写回磁盘
+    void sync(bool wait = true)
+    {
+        if(file_->readonly())
+            return;
+        file_->header()->count = this->size();
+        file_->sync(wait);
+    }
+
+private:
+    explicit MappedVector(MappedFile *file)
+        :MappedFileHolder(file), Base(MmapAllocator<T>(file))
+    {   attach();   }
+
+    //接管文件中已有的元素；只读时不暴露文件的剩余容量，追加元素必须经过分配器
+    void attach()
+    {
+        this->data_ = reinterpret_cast<T *>(file_->data());
+        this->avail_ = this->data_ + file_->header()->count;
+        this->limit_ = file_->readonly() ? this->avail_ : this->data_ + file_->capacityBytes() / sizeof(T);
+        file_->setInUse(true);
+    }
+};
+
+#endif  /* MAPPEDVECTOR_HPP */
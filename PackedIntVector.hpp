@@ -0,0 +1,368 @@
+#ifndef PACKEDINTVECTOR_HPP
+#define PACKEDINTVECTOR_HPP
+
+#include "Vector.hpp"
+#include <stdint.h>
+
+//PackedIntVector的编码方式
+//  FrameOfReference  每块减去块内最小值，按差值的最大位数存放，适合取值范围小的id
+//  DeltaCoding       先对相邻元素求差再做FrameOfReference，适合有序的id
+//两种方式对任意数据都能正确还原，只是不符合假设时压缩效果差
+struct FrameOfReference
+{
+    static const bool delta = false;
+};
+
+struct DeltaCoding
+{
+    static const bool delta = true;
+};
+
+namespace packed_detail
+{
+
+const size_t kBlockSize = 128;
+
+//保存v需要的位数
+inline unsigned bitWidth(uint64_t v)
+{
+    return v ? 64 - __builtin_clzll(v) : 0;
+}
+
+//每个值占width位，依次存放；128个值正好占2 * width个字，out要预先清零
+template <typename U>
+void packBlock(const U *in, unsigned width, uint64_t *out)
+{
+    if(width == 0)
+        return;
+    for(size_t ix = 0; ix != kBlockSize; ++ix)
+    {
+        size_t bit = ix * width, word = bit / 64, shift = bit % 64;
+        uint64_t v = static_cast<uint64_t>(in[ix]);
+        out[word] |= v << shift;
+        if(shift + width > 64)
+            out[word + 1] |= v >> (64 - shift);
+    }
+}
+
+//取出第ix个值
+inline uint64_t extract(const uint64_t *in, unsigned width, size_t ix)
+{
+    if(width == 0)
+        return 0;
+    size_t bit = ix * width, word = bit / 64, shift = bit % 64;
+    uint64_t v = in[word] >> shift;
+    if(shift + width > 64)
+        v |= in[word + 1] << (64 - shift);
+    return width == 64 ? v : v & ((uint64_t(1) << width) - 1);
+}
+
+//位数是编译期常量（大于0）的解码，out[i] = base + 第i个值
+//64个值正好占W个字，展开后每组内的移位量都是常量
+template <typename U, unsigned W>
+void unpackBlock(const uint64_t *in, U base, U *out)
+{
+    const uint64_t mask = W == 64 ? ~uint64_t(0) : (uint64_t(1) << (W % 64)) - 1;
+    for(size_t group = 0; group != kBlockSize / 64; ++group, in += W, out += 64)
+#pragma GCC unroll 64
+        for(unsigned ix = 0; ix != 64; ++ix)
+        {
+            const unsigned bit = ix * W, word = bit / 64, shift = bit % 64;
+            uint64_t v = in[word] >> shift;
+            if(shift + W > 64)
+                v |= in[word + 1] << (64 - shift);
+            out[ix] = static_cast<U>(base + (v & mask));
+        }
+}
+
+//位数为0时整块的值都相同
+template <typename U>
+void unpackZero(const uint64_t *, U base, U *out)
+{
+    std::fill(out, out + kBlockSize, base);
+}
+
+//填写table[0..W]
+template <typename U, unsigned W>
+struct FillUnpackers
+{
+    static void run(void (**table)(const uint64_t *, U, U *))
+    {
+        table[W] = unpackBlock<U, W>;
+        FillUnpackers<U, W - 1>::run(table);
+    }
+};
+
+template <typename U>
+struct FillUnpackers<U, 0>
+{
+    static void run(void (**table)(const uint64_t *, U, U *)) { table[0] = unpackZero<U>; }
+};
+
+template <typename U>
+struct Unpackers
+{
+    typedef void (*Fn)(const uint64_t *, U, U *);
+
+    Fn table[std::numeric_limits<U>::digits + 1];
+
+    Unpackers() { FillUnpackers<U, std::numeric_limits<U>::digits>::run(table); }
+};
+
+//按位数选择解码函数
+template <typename U>
+inline typename Unpackers<U>::Fn unpacker(unsigned width)
+{
+    static const Unpackers<U> unpackers;
+    return unpackers.table[width];
+}
+
+}
+
+//按块压缩存放的整数序列，每128个元素一块，每块按实际需要的位数存放：
+//  PackedIntVector<uint32_t, DeltaCoding> ids(sorted.begin(), sorted.end());
+//  ids.for_each([&](uint32_t id) { ... }); //顺序访问按块解码
+//最后不满一块的元素不压缩，push_back攒满一块时才编码；已经编码的元素不能修改
+//FrameOfReference的随机访问是O(1)，DeltaCoding需要从块首累加，最坏是O(128)
+template <typename T, typename Coding = FrameOfReference, typename Alloc = std::allocator<T> >
+class PackedIntVector
+{
+    static_assert(std::is_integral<T>::value, "PackedIntVector requires an integral type");
+
+public:
+    typedef T value_type;
+    typedef T const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef Alloc allocator_type;
+
+    static const size_type kBlockSize = packed_detail::kBlockSize;
+
+    //前向迭代器，内部缓存当前块解码后的结果，拷贝的开销与一块的大小相当
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        const_iterator() :vec_(NULL), pos_(0) { }
+        const_iterator(const PackedIntVector *vec, size_type pos) :vec_(vec), pos_(pos)
+        {
+            if(pos_ < vec_->size())
+                vec_->decode_block(pos_ / kBlockSize, buf_);
+        }
+
+        reference operator*() const { return buf_[pos_ % kBlockSize]; }
+        pointer operator->() const { return &**this; }
+        const_iterator &operator++()
+        {
+            if(++pos_ % kBlockSize == 0 && pos_ < vec_->size())
+                vec_->decode_block(pos_ / kBlockSize, buf_);
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const const_iterator &i, const const_iterator &j) { return i.pos_ == j.pos_; }
+        friend bool operator!=(const const_iterator &i, const const_iterator &j) { return i.pos_ != j.pos_; }
+
+    private:
+        const PackedIntVector *vec_;
+        size_type pos_;
+        T buf_[kBlockSize];
+    };
+
+    PackedIntVector() :size_(0) { }
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    PackedIntVector(In i, In j) :size_(0)
+    {
+        for(; i != j; ++i)
+            push_back(*i);
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+
+    T operator[] (size_type n) const;
+    T at(size_type n) const
+    {
+        if(n >= size_)
+            throw std::out_of_range("PackedIntVector::at");
+        return (*this)[n];
+    }
+    T front() const { return (*this)[0]; }
+    T back() const { return (*this)[size_ - 1]; }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    //块数，包括最后不满的一块
+    size_type num_blocks() const { return blocks_.size() + !tail_.empty(); }
+
+    void push_back(T val)
+    {
+        if(tail_.empty())
+            tail_.reserve(kBlockSize);
+        tail_.push_back(val);
+        ++size_;
+        if(tail_.size() == kBlockSize)
+            flush();
+    }
+    void clear()
+    {
+        words_.clear();
+        blocks_.clear();
+        tail_.clear();
+        size_ = 0;
+    }
+    void shrink_to_fit()
+    {
+        words_.shrink_to_fit();
+        blocks_.shrink_to_fit();
+    }
+
+    //把第b块解码到out，返回元素个数，只有最后一块可能不满kBlockSize
+    size_type decode_block(size_type b, T *out) const;
+    //按顺序对每个元素调用f，每次解码一块到栈上的缓冲区
+    template <typename F>
+    void for_each(F f) const;
+
+    //占用的内存，按容量计算
+    size_type memory_bytes() const
+    {
+        return words_.capacity() * sizeof(uint64_t) + blocks_.capacity() * sizeof(Block)
+             + tail_.capacity() * sizeof(T);
+    }
+    //同样多元素的Vector<T>与编码后数据的大小之比，不计容量的冗余
+    double compression_ratio() const
+    {
+        size_type encoded = words_.size() * sizeof(uint64_t) + blocks_.size() * sizeof(Block)
+                          + tail_.size() * sizeof(T);
+        return encoded ? static_cast<double>(size_ * sizeof(T)) / encoded : 1.0;
+    }
+
+private:
+    typedef typename std::make_unsigned<T>::type U;
+
+    //FrameOfReference：元素 = base + 存放的值
+    //DeltaCoding：第一个元素是base，之后每个元素 = 前一个 + step + 存放的值，第一个存放的值是0
+    struct Block
+    {
+        U base;
+        U step;
+        size_type offset; //在words_中的位置
+        unsigned width;
+    };
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<uint64_t> WordAlloc;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Block> BlockAlloc;
+
+    void flush();
+
+    Vector<uint64_t, WordAlloc> words_;
+    Vector<Block, BlockAlloc> blocks_;
+    Vector<T, Alloc> tail_; //还没有编码的元素
+    size_type size_;
+};
+
+template <typename T, typename Coding, typename Alloc>
+const typename PackedIntVector<T, Coding, Alloc>::size_type PackedIntVector<T, Coding, Alloc>::kBlockSize;
+
+template <typename T, typename Coding, typename Alloc>
+void PackedIntVector<T, Coding, Alloc>::flush()
+{
+    U stored[kBlockSize];
+    Block b;
+    if(Coding::delta)
+    {
+        b.base = static_cast<U>(tail_[0]);
+        stored[0] = 0;
+        for(size_type ix = 1; ix != kBlockSize; ++ix)
+            stored[ix] = static_cast<U>(static_cast<U>(tail_[ix]) - static_cast<U>(tail_[ix - 1]));
+        b.step = *std::min_element(stored + 1, stored + kBlockSize);
+        for(size_type ix = 1; ix != kBlockSize; ++ix)
+            stored[ix] = static_cast<U>(stored[ix] - b.step);
+    }
+    else
+    {
+        b.base = static_cast<U>(*std::min_element(tail_.begin(), tail_.end()));
+        b.step = 0;
+        for(size_type ix = 0; ix != kBlockSize; ++ix)
+            stored[ix] = static_cast<U>(static_cast<U>(tail_[ix]) - b.base);
+    }
+    //差值都是无符号的，按位或得到最高位
+    U bits = 0;
+    for(size_type ix = 0; ix != kBlockSize; ++ix)
+        bits |= stored[ix];
+    b.width = packed_detail::bitWidth(bits);
+    b.offset = words_.size();
+
+    //先保证blocks_有空位，push_back不会失败，words_扩充失败时什么都没有改变；按倍数预留，不能每块重新分配
+    if(blocks_.size() == blocks_.capacity())
+        blocks_.reserve(std::max<size_type>(8, 2 * blocks_.capacity()));
+    words_.resize(words_.size() + 2 * b.width);
+    packed_detail::packBlock(stored, b.width, words_.data() + b.offset);
+    blocks_.push_back(b);
+    tail_.clear();
+}
+
+template <typename T, typename Coding, typename Alloc>
+T PackedIntVector<T, Coding, Alloc>::operator[] (size_type n) const
+{
+    size_type block = n / kBlockSize, ix = n % kBlockSize;
+    if(block == blocks_.size())
+        return tail_[ix];
+    const Block &b = blocks_[block];
+    const uint64_t *in = words_.data() + b.offset;
+    if(!Coding::delta)
+        return static_cast<T>(static_cast<U>(b.base + packed_detail::extract(in, b.width, ix)));
+    U val = static_cast<U>(b.base + ix * b.step);
+    for(size_type jx = 1; jx <= ix; ++jx)
+        val = static_cast<U>(val + packed_detail::extract(in, b.width, jx));
+    return static_cast<T>(val);
+}
+
+template <typename T, typename Coding, typename Alloc>
+typename PackedIntVector<T, Coding, Alloc>::size_type
+PackedIntVector<T, Coding, Alloc>::decode_block(size_type block, T *out) const
+{
+    if(block == blocks_.size())
+    {
+        std::copy(tail_.begin(), tail_.end(), out);
+        return tail_.size();
+    }
+    const Block &b = blocks_[block];
+    U *vals = reinterpret_cast<U *>(out); //有符号和无符号类型可以互相别名
+    if(Coding::delta)
+    {
+        //先得到相邻元素的差，再求前缀和
+        packed_detail::unpacker<U>(b.width)(words_.data() + b.offset, b.step, vals);
+        vals[0] = b.base;
+        for(size_type ix = 1; ix != kBlockSize; ++ix)
+            vals[ix] = static_cast<U>(vals[ix] + vals[ix - 1]);
+    }
+    else
+        packed_detail::unpacker<U>(b.width)(words_.data() + b.offset, b.base, vals);
+    return kBlockSize;
+}
+
+template <typename T, typename Coding, typename Alloc>
+template <typename F>
+void PackedIntVector<T, Coding, Alloc>::for_each(F f) const
+{
+    T buf[kBlockSize];
+    for(size_type block = 0; block != num_blocks(); ++block)
+    {
+        size_type n = decode_block(block, buf);
+        for(size_type ix = 0; ix != n; ++ix)
+            f(buf[ix]);
+    }
+}
+
+#endif  /* PACKEDINTVECTOR_HPP */
@@ -0,0 +1,438 @@
+#ifndef RINGVECTOR_HPP
+#define RINGVECTOR_HPP
+
+#include "Vector.hpp"
+
+//环形缓冲区：元素从head_开始存放，到缓冲区末尾后绕回开头，两端的插入和删除都是O(1)
+//适合作为工作队列，代替Vector的erase(begin())：
+//  RingVector<Task> queue;
+//  queue.push_back(task);
+//  Task next = std::move(queue.front()); queue.pop_front();
+//bounded(n)创建容量固定为n的缓冲区，满了以后push_back覆盖最旧的元素，push_front覆盖最新的元素，
+//适合只保留最近n条记录的遥测数据
+//内存由Alloc分配，容量按Growth增长，能按字节搬迁的元素扩容时直接memcpy
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = GrowDouble>
+class RingVector : private VectorAllocHolder<Alloc>
+{
+    typedef VectorAllocHolder<Alloc> AllocHolder;
+    typedef std::allocator_traits<Alloc> alloc_traits;
+
+    //逻辑下标n对应的物理位置是head + n，超过容量时绕回开头
+    template <typename Ref, typename Ptr>
+    class basic_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+
+        basic_iterator() :base_(NULL), head_(0), cap_(0), n_(0) { }
+        basic_iterator(Ptr base, size_t head, size_t cap, size_t n)
+            :base_(base), head_(head), cap_(cap), n_(n) { }
+        //提供从iterator到const_iterator的转换
+        template <typename R, typename P>
+        basic_iterator(const basic_iterator<R, P> &it)
+            :base_(it.base_), head_(it.head_), cap_(it.cap_), n_(it.n_) { }
+
+        reference operator*() const
+        {
+            size_t p = head_ + n_;
+            return base_[p < cap_ ? p : p - cap_];
+        }
+        pointer operator->() const
+        {   return &**this; }
+        reference operator[](difference_type d) const
+        {   return *(*this + d);    }
+
+        basic_iterator &operator++() { ++n_; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp(*this); ++n_; return temp; }
+        basic_iterator &operator--() { --n_; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp(*this); --n_; return temp; }
+        basic_iterator &operator+=(difference_type d) { n_ += d; return *this; }
+        basic_iterator &operator-=(difference_type d) { n_ -= d; return *this; }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type d)
+        {   return it += d; }
+        friend basic_iterator operator+(difference_type d, basic_iterator it)
+        {   return it += d; }
+        friend basic_iterator operator-(basic_iterator it, difference_type d)
+        {   return it -= d; }
+        friend difference_type operator-(const basic_iterator &i, const basic_iterator &j)
+        {   return static_cast<difference_type>(i.n_) - static_cast<difference_type>(j.n_);    }
+
+        friend bool operator==(const basic_iterator &i, const basic_iterator &j) { return i.n_ == j.n_; }
+        friend bool operator!=(const basic_iterator &i, const basic_iterator &j) { return i.n_ != j.n_; }
+        friend bool operator<(const basic_iterator &i, const basic_iterator &j) { return i.n_ < j.n_; }
+        friend bool operator>(const basic_iterator &i, const basic_iterator &j) { return i.n_ > j.n_; }
+        friend bool operator<=(const basic_iterator &i, const basic_iterator &j) { return i.n_ <= j.n_; }
+        friend bool operator>=(const basic_iterator &i, const basic_iterator &j) { return i.n_ >= j.n_; }
+
+    private:
+        template <typename R, typename P>
+        friend class basic_iterator;
+
+        Ptr base_; //缓冲区的起始位置
+        size_t head_;
+        size_t cap_;
+        size_t n_; //逻辑下标
+    };
+
+public:
+    typedef T value_type;
+    typedef basic_iterator<T &, T *> iterator;
+    typedef basic_iterator<const T &, const T *> const_iterator;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef Alloc allocator_type;
+
+    explicit RingVector(const allocator_type &a = allocator_type())
+        :AllocHolder(a), data_(NULL), head_(0), size_(0), cap_(0), bound_(0) { }
+    explicit RingVector(size_type n, const value_type &val = value_type(),
+                        const allocator_type &a = allocator_type())
+        :AllocHolder(a), data_(NULL), head_(0), size_(0), cap_(0), bound_(0)
+    {
+        try
+        {
+            reserve(n);
+            for(; size_ != n; ++size_)
+                alloc_traits::construct(alloc(), data_ + size_, val);
+        }
+        catch(...)
+        {
+            uncreate();
+            throw;
+        }
+    }
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    RingVector(In i, In j, const allocator_type &a = allocator_type())
+        :AllocHolder(a), data_(NULL), head_(0), size_(0), cap_(0), bound_(0)
+    {
+        try
+        {
+            for(; i != j; ++i)
+                emplace_back(*i);
+        }
+        catch(...)
+        {
+            uncreate();
+            throw;
+        }
+    }
+    //容量固定为n，满了以后覆盖最旧的元素，n不能为0
+    static RingVector bounded(size_type n, const allocator_type &a = allocator_type())
+    {
+        if(n == 0)
+            throw std::invalid_argument("RingVector::bounded");
+        RingVector ring(a);
+        ring.reserve(n);
+        ring.bound_ = n;
+        return ring;
+    }
+
+    RingVector(const RingVector &other)
+        :AllocHolder(alloc_traits::select_on_container_copy_construction(other.alloc())),
+         data_(NULL), head_(0), size_(0), cap_(0), bound_(0)
+    {
+        try
+        {
+            reserve(other.bound_ ? other.bound_ : other.size_);
+            for(const_iterator it = other.begin(); it != other.end(); ++it, ++size_)
+                alloc_traits::construct(alloc(), data_ + size_, *it);
+        }
+        catch(...)
+        {
+            uncreate();
+            throw;
+        }
+        bound_ = other.bound_;
+    }
+    RingVector(RingVector &&other) noexcept
+        :AllocHolder(std::move(other.alloc())), data_(other.data_), head_(other.head_),
+         size_(other.size_), cap_(other.cap_), bound_(other.bound_)
+    {
+        other.data_ = NULL;
+        other.head_ = other.size_ = other.cap_ = other.bound_ = 0;
+    }
+    RingVector &operator=(RingVector other)
+    {
+        swap(other);
+        return *this;
+    }
+    ~RingVector() { uncreate(); }
+
+    void swap(RingVector &other)
+    {
+        //与Vector相同：分配器不随swap传播且不相等时不能交换内存，只能交换元素
+        if(!alloc_traits::propagate_on_container_swap::value && alloc() != other.alloc())
+        {
+            swapElements(other);
+            return;
+        }
+        using std::swap;
+        if(alloc_traits::propagate_on_container_swap::value)
+            swap(alloc(), other.alloc());
+        swap(data_, other.data_);
+        swap(head_, other.head_);
+        swap(size_, other.size_);
+        swap(cap_, other.cap_);
+        swap(bound_, other.bound_);
+    }
+
+    reference operator[] (size_type n) { return data_[physical(n)]; }
+    const_reference operator[] (size_type n) const { return data_[physical(n)]; }
+    reference at(size_type n)
+    {
+        if(n >= size_)
+            throw std::out_of_range("RingVector::at");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const
+    {
+        if(n >= size_)
+            throw std::out_of_range("RingVector::at");
+        return (*this)[n];
+    }
+    reference front() { return data_[head_]; }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference front() const { return data_[head_]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+
+    iterator begin() { return iterator(data_, head_, cap_, 0); }
+    iterator end() { return iterator(data_, head_, cap_, size_); }
+    const_iterator begin() const { return const_iterator(data_, head_, cap_, 0); }
+    const_iterator end() const { return const_iterator(data_, head_, cap_, size_); }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return cap_; }
+    size_type max_size() const
+    {
+        return std::min<size_type>(alloc_traits::max_size(alloc()),
+            std::numeric_limits<difference_type>::max() / sizeof(T));
+    }
+    //bounded创建的缓冲区返回固定的容量，否则返回0
+    size_type bound() const { return bound_; }
+    bool full() const { return bound_ != 0 && size_ == bound_; }
+
+    //迭代器在插入、删除之后失效；bounded缓冲区满了以后会覆盖另一端的元素
+    void push_back(const T &t) { emplace_back(t); }
+    void push_back(T &&t) { emplace_back(std::move(t)); }
+    template <typename... Args>
+    void emplace_back(Args&&... args);
+    void push_front(const T &t) { emplace_front(t); }
+    void push_front(T &&t) { emplace_front(std::move(t)); }
+    template <typename... Args>
+    void emplace_front(Args&&... args);
+
+    void pop_front()
+    {
+        alloc_traits::destroy(alloc(), data_ + head_);
+        head_ = head_ + 1 == cap_ ? 0 : head_ + 1;
+        --size_;
+    }
+    void pop_back()
+    {
+        alloc_traits::destroy(alloc(), data_ + physical(size_ - 1));
+        --size_;
+    }
+    void clear()
+    {
+        while(size_ != 0)
+            pop_back();
+        head_ = 0;
+    }
+
+    //bounded缓冲区的容量不能超过固定的大小
+    void reserve(size_type n);
+
+    //元素是否在内存中连续存放
+    bool is_contiguous() const { return head_ + size_ <= cap_; }
+    //保证元素连续存放并返回第一个元素的地址，需要时把元素转到缓冲区开头，O(n)
+    T *as_contiguous();
+
+    allocator_type get_allocator() const { return alloc(); }
+
+    friend bool operator==(const RingVector &lhs, const RingVector &rhs)
+    {   return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());    }
+    friend bool operator!=(const RingVector &lhs, const RingVector &rhs)
+    {   return !(lhs == rhs);   }
+    friend bool operator<(const RingVector &lhs, const RingVector &rhs)
+    {   return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());  }
+
+private:
+    Alloc &alloc() { return AllocHolder::get(); }
+    const Alloc &alloc() const { return AllocHolder::get(); }
+
+    size_type physical(size_type n) const
+    {
+        size_type p = head_ + n;
+        return p < cap_ ? p : p - cap_;
+    }
+
+    //缓冲区满时腾出一个位置：bounded缓冲区删除一个元素，drop_front决定删除哪一端，否则扩容
+    void makeRoom(bool drop_front);
+    //按逻辑顺序把元素搬到容量为n的新缓冲区的开头
+    void relocate(size_type n);
+    void swapElements(RingVector &other);
+    void uncreate();
+
+    T *data_;
+    size_type head_; //第一个元素的物理位置
+    size_type size_;
+    size_type cap_;
+    size_type bound_; //0表示容量不受限制
+};
+
+template <typename T, typename Alloc, typename Growth>
+void RingVector<T, Alloc, Growth>::makeRoom(bool drop_front)
+{
+    if(bound_ != 0)
+    {
+        if(drop_front)
+            pop_front();
+        else
+            pop_back();
+        return;
+    }
+    if(size_ == max_size())
+        throw std::length_error("RingVector");
+    relocate(Growth::next(cap_, size_ + 1, sizeof(T), max_size()));
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename... Args>
+void RingVector<T, Alloc, Growth>::emplace_back(Args&&... args)
+{
+    if(size_ == cap_)
+    {
+        value_type tmp(std::forward<Args>(args)...); //args可能引用容器中的元素
+        makeRoom(true);
+        alloc_traits::construct(alloc(), data_ + physical(size_), std::move(tmp));
+    }
+    else
+        alloc_traits::construct(alloc(), data_ + physical(size_), std::forward<Args>(args)...);
+    ++size_;
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename... Args>
+void RingVector<T, Alloc, Growth>::emplace_front(Args&&... args)
+{
+    if(size_ == cap_)
+    {
+        value_type tmp(std::forward<Args>(args)...);
+        makeRoom(false);
+        head_ = head_ == 0 ? cap_ - 1 : head_ - 1;
+        alloc_traits::construct(alloc(), data_ + head_, std::move(tmp));
+    }
+    else
+    {
+        size_type slot = head_ == 0 ? cap_ - 1 : head_ - 1;
+        alloc_traits::construct(alloc(), data_ + slot, std::forward<Args>(args)...);
+        head_ = slot;
+    }
+    ++size_;
+}
+
+template <typename T, typename Alloc, typename Growth>
+void RingVector<T, Alloc, Growth>::reserve(size_type n)
+{
+    if(n <= cap_)
+        return;
+    if(n > max_size() || (bound_ != 0 && n > bound_))
+        throw std::length_error("RingVector::reserve");
+    relocate(n);
+}
+
+template <typename T, typename Alloc, typename Growth>
+void RingVector<T, Alloc, Growth>::relocate(size_type n)
+{
+    T *new_data = alloc_traits::allocate(alloc(), n);
+    //元素分成[head_, cap_)和绕回开头的[0, second)两段
+    size_type first = std::min(size_, cap_ - head_), second = size_ - first;
+    if(is_trivially_relocatable<T>::value)
+    {
+        if(data_ != NULL)
+        {
+            memcpy(static_cast<void *>(new_data), static_cast<const void *>(data_ + head_), first * sizeof(T));
+            memcpy(static_cast<void *>(new_data + first), static_cast<const void *>(data_), second * sizeof(T));
+        }
+    }
+    else
+    {
+        T *first_end = new_data;
+        try
+        {
+            first_end = uninitializedMoveIfNoexcept(data_ + head_, data_ + head_ + first, new_data);
+            uninitializedMoveIfNoexcept(data_, data_ + second, first_end);
+        }
+        catch(...)
+        {
+            for(T *p = new_data; p != first_end; ++p)
+                alloc_traits::destroy(alloc(), p);
+            alloc_traits::deallocate(alloc(), new_data, n);
+            throw;
+        }
+        for(size_type ix = 0; ix != size_; ++ix)
+            alloc_traits::destroy(alloc(), data_ + physical(ix));
+    }
+    if(data_ != NULL)
+        alloc_traits::deallocate(alloc(), data_, cap_);
+
+    data_ = new_data;
+    head_ = 0;
+    cap_ = n;
+}
+
+template <typename T, typename Alloc, typename Growth>
+T *RingVector<T, Alloc, Growth>::as_contiguous()
+{
+    if(is_contiguous())
+        return data_ + head_;
+    if(is_trivially_relocatable<T>::value)
+    {
+        //按字节把整个缓冲区左转head_个元素，不需要额外的内存
+        char *bytes = reinterpret_cast<char *>(data_);
+        std::rotate(bytes, bytes + head_ * sizeof(T), bytes + cap_ * sizeof(T));
+        head_ = 0;
+    }
+    else
+        relocate(cap_);
+    return data_;
+}
+
+template <typename T, typename Alloc, typename Growth>
+void RingVector<T, Alloc, Growth>::swapElements(RingVector &other)
+{
+    //固定容量跟着容器不交换，放不下对方的元素时抛出length_error，两边都不变
+    if((bound_ != 0 && other.size_ > bound_) || (other.bound_ != 0 && size_ > other.bound_))
+        throw std::length_error("RingVector::swap");
+    RingVector &shorter = size() < other.size() ? *this : other;
+    RingVector &longer = size() < other.size() ? other : *this;
+    size_type n = shorter.size();
+    std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+    for(size_type ix = n; ix != longer.size(); ++ix)
+        shorter.push_back(std::move(longer[ix]));
+    while(longer.size() != n)
+        longer.pop_back();
+}
+
+template <typename T, typename Alloc, typename Growth>
+void RingVector<T, Alloc, Growth>::uncreate()
+{
+    if(data_ == NULL)
+        return;
+    for(size_type ix = 0; ix != size_; ++ix)
+        alloc_traits::destroy(alloc(), data_ + physical(ix));
+    alloc_traits::deallocate(alloc(), data_, cap_);
+    data_ = NULL;
+    head_ = size_ = cap_ = 0;
+}
+
+#endif  /* RINGVECTOR_HPP */
@@ -0,0 +1,187 @@
+#ifndef SMALLVECTOR_HPP
+#define SMALLVECTOR_HPP
+
+#include "Vector.hpp"
+
+//SmallVector使用的分配器：请求不超过内部缓冲区时直接返回缓冲区
+//缓冲区被占用或者容量不够时才向堆申请
+template <typename T>
+class InlineBufferAllocator
+{
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind { typedef InlineBufferAllocator<U> other; };
+
+    InlineBufferAllocator() :buffer_(NULL), size_(0), used_(false) { }
+    InlineBufferAllocator(pointer buffer, size_type n)
+        :buffer_(buffer), size_(n), used_(false) { }
+
+    allocation_result<pointer> allocate_at_least(size_type n)
+    {
+        allocation_result<pointer> result;
+        if(n <= size_ && !used_)
+        {
+            used_ = true;
+            result.ptr = buffer_;
+            result.count = size_;
+        }
+        else
+        {
+            result.ptr = std::allocator<T>().allocate(n);
+            result.count = n;
+        }
+        return result;
+    }
+    pointer allocate(size_type n)
+    {   return allocate_at_least(n).ptr;   }
+    void deallocate(pointer p, size_type n)
+    {
+        if(p == buffer_)
+            used_ = false;
+        else if(p != NULL)
+            std::allocator<T>().deallocate(p, n);
+    }
+
+    //拷贝出来的容器不能共用这块缓冲区
+    InlineBufferAllocator select_on_container_copy_construction() const
+    {   return InlineBufferAllocator();  }
+
+    pointer buffer() const { return buffer_; }
+
+private:
+    pointer buffer_; //内部缓冲区
+    size_type size_; //缓冲区能容纳的元素个数
+    bool used_;
+};
+
+template <typename T, typename U>
+bool operator==(const InlineBufferAllocator<T> &lhs, const InlineBufferAllocator<U> &rhs)
+{   return lhs.buffer() == rhs.buffer();  }
+template <typename T, typename U>
+bool operator!=(const InlineBufferAllocator<T> &lhs, const InlineBufferAllocator<U> &rhs)
+{   return lhs.buffer() != rhs.buffer();  }
+
+//与N无关的公共部分，函数参数可以写成SmallVectorImpl<T>&
+//所有操作都由Vector完成，元素超过N个时growToN把它们搬到堆上
+template <typename T>
+class SmallVectorImpl : public Vector<T, InlineBufferAllocator<T> >
+{
+    typedef Vector<T, InlineBufferAllocator<T> > Base;
+public:
+    SmallVectorImpl(const SmallVectorImpl &) = delete;
+
+    SmallVectorImpl &operator=(const SmallVectorImpl &rhs)
+    {
+        Base::operator=(rhs);
+        return *this;
+    }
+    SmallVectorImpl &operator=(SmallVectorImpl &&rhs);
+
+    void swap(SmallVectorImpl &other);
+
+    //元素是否还在内部缓冲区中
+    bool isSmall() const { return this->data_ == this->alloc().buffer(); }
+    //内部缓冲区不能缩小；堆上的元素不超过N个时回到内部缓冲区
+    void shrink_to_fit()
+    {
+        if(this->data_ != NULL && !isSmall())
+            Base::shrink_to_fit();
+    }
+
+protected:
+    explicit SmallVectorImpl(const InlineBufferAllocator<T> &a) :Base(a) { }
+    ~SmallVectorImpl() { }
+
+    void stealHeap(SmallVectorImpl &rhs);
+};
+
+template <typename T>
+SmallVectorImpl<T> &SmallVectorImpl<T>::operator=(SmallVectorImpl &&rhs)
+{
+    if(this == &rhs)
+        return *this;
+    if(rhs.data_ != NULL && !rhs.isSmall()) //堆上的内存可以直接接管
+    {
+        this->uncreate();
+        stealHeap(rhs);
+    }
+    else
+    {
+        Base::operator=(std::move(rhs)); //分配器不同，逐个移动
+        rhs.clear();
+    }
+    return *this;
+}
+
+template <typename T>
+void SmallVectorImpl<T>::swap(SmallVectorImpl &other)
+{
+    if(this->isSmall() || other.isSmall())
+    {
+        Base::swap(other); //分配器不同，逐个交换元素
+        return;
+    }
+    std::swap(this->data_, other.data_);
+    std::swap(this->avail_, other.avail_);
+    std::swap(this->limit_, other.limit_);
+}
+
+template <typename T>
+void SmallVectorImpl<T>::stealHeap(SmallVectorImpl &rhs)
+{
+    this->data_ = rhs.data_;
+    this->avail_ = rhs.avail_;
+    this->limit_ = rhs.limit_;
+    rhs.create(); //rhs下次插入时重新使用自己的缓冲区
+}
+
+//最多N个元素保存在对象内部，不需要堆分配
+template <typename T, size_t N>
+class SmallVector : public SmallVectorImpl<T>
+{
+    typedef SmallVectorImpl<T> Impl;
+public:
+    typedef typename Impl::size_type size_type;
+    typedef typename Impl::value_type value_type;
+
+    SmallVector() :Impl(inlineAllocator())
+    {   this->reserve(N);  }
+    explicit SmallVector(size_type n, const value_type &val = value_type())
+        :Impl(inlineAllocator())
+    {   this->assign(n, val);  }
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    SmallVector(In i, In j) :Impl(inlineAllocator())
+    {   this->assign(i, j);  }
+
+    SmallVector(const SmallVector &other) :Impl(inlineAllocator())
+    {   this->assign(other.begin(), other.end());    }
+    SmallVector(SmallVector &&other) :Impl(inlineAllocator())
+    {   Impl::operator=(std::move(other));   }
+    SmallVector(SmallVectorImpl<T> &&other) :Impl(inlineAllocator())
+    {   Impl::operator=(std::move(other));   }
+
+    SmallVector &operator=(const SmallVector &other)
+    {
+        Impl::operator=(other);
+        return *this;
+    }
+    SmallVector &operator=(SmallVector &&other)
+    {
+        Impl::operator=(std::move(other));
+        return *this;
+    }
+
+private:
+    InlineBufferAllocator<T> inlineAllocator()
+    {   return InlineBufferAllocator<T>(reinterpret_cast<T *>(&buffer_), N);  }
+
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buffer_;
+};
+
+#endif  /* SMALLVECTOR_HPP */
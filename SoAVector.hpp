@@ -0,0 +1,463 @@
+#ifndef SOAVECTOR_HPP
+#define SOAVECTOR_HPP
+
+#include "Vector.hpp"
+#include <tuple>
+#include <new>
+#include <stdlib.h>
+
+namespace soa_detail
+{
+
+//C++11没有std::index_sequence，这里是一个最小的实现
+template <size_t... I>
+struct index_sequence { };
+
+template <size_t N, size_t... I>
+struct make_index_sequence : make_index_sequence<N - 1, N - 1, I...> { };
+
+template <size_t... I>
+struct make_index_sequence<0, I...> : index_sequence<I...> { };
+
+template <bool... B>
+struct all_of;
+template <>
+struct all_of<> : std::true_type { };
+template <bool B, bool... Rest>
+struct all_of<B, Rest...> : std::integral_constant<bool, B && all_of<Rest...>::value> { };
+
+}
+
+//结构数组：每个字段单独存成一列，只扫描少数字段时不会把整行读进缓存
+//所有列放在同一块内存中，每列按缓存行对齐，所有列的容量一起按GrowDouble增长
+//v[n]返回std::tuple<Fields &...>作为行的代理，column<I>()返回第I列的VectorView，可以直接向量化扫描
+//为了让扩容和插入不会中途失败，字段的移动构造、移动赋值必须不抛异常
+template <typename... Fields>
+class SoAVector
+{
+    static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+    static_assert(soa_detail::all_of<std::is_nothrow_move_constructible<Fields>::value...>::value
+                  && soa_detail::all_of<std::is_nothrow_move_assignable<Fields>::value...>::value,
+                  "SoAVector fields must be nothrow movable");
+    static_assert(soa_detail::all_of<(alignof(Fields) <= 64)...>::value, "SoAVector field alignment exceeds 64");
+
+    typedef soa_detail::make_index_sequence<sizeof...(Fields)> Indices;
+    typedef std::tuple<Fields *...> Columns;
+
+    static const size_t kColumnAlign = 64; //每列从新的缓存行开始
+
+    template <typename Ref, typename Owner>
+    class basic_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::tuple<Fields...> value_type;
+        typedef ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef Ref reference;
+
+        basic_iterator() :owner_(NULL), n_(0) { }
+        basic_iterator(Owner *owner, size_t n) :owner_(owner), n_(n) { }
+        //提供从iterator到const_iterator的转换
+        template <typename R, typename O>
+        basic_iterator(const basic_iterator<R, O> &it) :owner_(it.owner_), n_(it.n_) { }
+
+        reference operator*() const { return (*owner_)[n_]; }
+        reference operator[](difference_type d) const { return (*owner_)[n_ + d]; }
+
+        basic_iterator &operator++() { ++n_; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp(*this); ++n_; return temp; }
+        basic_iterator &operator--() { --n_; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp(*this); --n_; return temp; }
+        basic_iterator &operator+=(difference_type d) { n_ += d; return *this; }
+        basic_iterator &operator-=(difference_type d) { n_ -= d; return *this; }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type d) { return it += d; }
+        friend basic_iterator operator+(difference_type d, basic_iterator it) { return it += d; }
+        friend basic_iterator operator-(basic_iterator it, difference_type d) { return it -= d; }
+        friend difference_type operator-(const basic_iterator &i, const basic_iterator &j)
+        {   return static_cast<difference_type>(i.n_) - static_cast<difference_type>(j.n_);    }
+
+        friend bool operator==(const basic_iterator &i, const basic_iterator &j) { return i.n_ == j.n_; }
+        friend bool operator!=(const basic_iterator &i, const basic_iterator &j) { return i.n_ != j.n_; }
+        friend bool operator<(const basic_iterator &i, const basic_iterator &j) { return i.n_ < j.n_; }
+        friend bool operator>(const basic_iterator &i, const basic_iterator &j) { return i.n_ > j.n_; }
+        friend bool operator<=(const basic_iterator &i, const basic_iterator &j) { return i.n_ <= j.n_; }
+        friend bool operator>=(const basic_iterator &i, const basic_iterator &j) { return i.n_ >= j.n_; }
+
+        size_t index() const { return n_; }
+
+    private:
+        template <typename R, typename O>
+        friend class basic_iterator;
+
+        Owner *owner_;
+        size_t n_; //行号
+    };
+
+public:
+    typedef std::tuple<Fields...> value_type;
+    typedef std::tuple<Fields &...> reference;
+    typedef std::tuple<const Fields &...> const_reference;
+    typedef basic_iterator<reference, SoAVector> iterator;
+    typedef basic_iterator<const_reference, const SoAVector> const_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    //第I个字段的类型
+    template <size_t I>
+    struct field { typedef typename std::tuple_element<I, value_type>::type type; };
+
+    SoAVector() :buffer_(NULL), size_(0), cap_(0) { }
+    explicit SoAVector(size_type n) :buffer_(NULL), size_(0), cap_(0) { resize(n); }
+    SoAVector(const SoAVector &other);
+    SoAVector(SoAVector &&other) noexcept
+        :buffer_(other.buffer_), columns_(other.columns_), size_(other.size_), cap_(other.cap_)
+    {
+        other.buffer_ = NULL;
+        other.size_ = other.cap_ = 0;
+    }
+    SoAVector &operator=(SoAVector other)
+    {
+        swap(other);
+        return *this;
+    }
+    ~SoAVector() { uncreate(); }
+
+    void swap(SoAVector &other)
+    {
+        std::swap(buffer_, other.buffer_);
+        std::swap(columns_, other.columns_);
+        std::swap(size_, other.size_);
+        std::swap(cap_, other.cap_);
+    }
+
+    reference operator[] (size_type n) { return row<reference>(*this, n, Indices()); }
+    const_reference operator[] (size_type n) const { return row<const_reference>(*this, n, Indices()); }
+    reference front() { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference front() const { return (*this)[0]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+
+    template <size_t I>
+    VectorView<typename field<I>::type> column()
+    {   return VectorView<typename field<I>::type>(std::get<I>(columns_), size_); }
+    template <size_t I>
+    VectorView<const typename field<I>::type> column() const
+    {   return VectorView<const typename field<I>::type>(std::get<I>(columns_), size_);   }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size_); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return cap_; }
+    size_type max_size() const
+    {   return std::numeric_limits<difference_type>::max() / (rowBytes() + sizeof...(Fields) * kColumnAlign); }
+
+    //每个参数构造一个字段
+    void push_back(const Fields &... fields)
+    {   emplace_back(fields...);    }
+    template <typename... Args>
+    void emplace_back(Args&&... args);
+    void pop_back()
+    {
+        --size_;
+        destroyRows(size_, size_ + 1, Indices());
+    }
+
+    iterator insert(const_iterator position, const Fields &... fields);
+    iterator erase(const_iterator position)
+    {   return erase(position, position + 1);  }
+    iterator erase(const_iterator first, const_iterator last);
+    void clear() { erase(begin(), end()); }
+
+    void resize(size_type n);
+    void reserve(size_type n);
+
+    //逐列比较
+    friend bool operator==(const SoAVector &lhs, const SoAVector &rhs)
+    {   return lhs.size_ == rhs.size_ && equalColumns(lhs, rhs, Indices());  }
+    friend bool operator!=(const SoAVector &lhs, const SoAVector &rhs)
+    {   return !(lhs == rhs);   }
+
+private:
+    static size_type rowBytes()
+    {
+        size_type sizes[] = {sizeof(Fields)...};
+        size_type sum = 0;
+        for(size_type ix = 0; ix != sizeof...(Fields); ++ix)
+            sum += sizes[ix];
+        return sum;
+    }
+    static size_type alignUp(size_type bytes)
+    {   return (bytes + kColumnAlign - 1) & ~(kColumnAlign - 1);   }
+    //容量为cap时第k列的起始偏移，k等于列数时是总字节数
+    static size_type columnOffset(size_type k, size_type cap)
+    {
+        size_type sizes[] = {sizeof(Fields)...};
+        size_type offset = 0;
+        for(size_type ix = 0; ix != k; ++ix)
+            offset += alignUp(cap * sizes[ix]);
+        return offset;
+    }
+
+    template <size_t... I>
+    static Columns makeColumns(char *base, size_type cap, soa_detail::index_sequence<I...>)
+    {   return Columns(reinterpret_cast<typename field<I>::type *>(base + columnOffset(I, cap))...);   }
+
+    template <typename Ref, typename Self, size_t... I>
+    static Ref row(Self &self, size_type n, soa_detail::index_sequence<I...>)
+    {   return Ref(std::get<I>(self.columns_)[n]...);   }
+
+    template <size_t... I>
+    static bool equalColumns(const SoAVector &lhs, const SoAVector &rhs, soa_detail::index_sequence<I...>)
+    {
+        bool results[] = {vector_compare::equal(std::get<I>(lhs.columns_), std::get<I>(rhs.columns_), lhs.size_)...};
+        for(size_type ix = 0; ix != sizeof...(I); ++ix)
+            if(!results[ix])
+                return false;
+        return true;
+    }
+
+    //把一列的[0, n)搬到未初始化的dest
+    template <typename F>
+    static void relocateColumn(F *src, F *dest, size_type n)
+    {
+        if(is_trivially_relocatable<F>::value)
+        {
+            if(n != 0)
+                memcpy(static_cast<void *>(dest), static_cast<const void *>(src), n * sizeof(F));
+            return;
+        }
+        std::uninitialized_copy(std::make_move_iterator(src), std::make_move_iterator(src + n), dest);
+        for(size_type ix = 0; ix != n; ++ix)
+            src[ix].~F();
+    }
+    template <size_t... I>
+    void relocateRows(const Columns &dest, soa_detail::index_sequence<I...>)
+    {
+        int expand[] = {0, (relocateColumn(std::get<I>(columns_), std::get<I>(dest), size_), 0)...};
+        (void)expand;
+    }
+
+    template <typename F>
+    static void destroyColumn(F *col, size_type first, size_type last)
+    {
+        for(size_type ix = first; ix != last; ++ix)
+            col[ix].~F();
+    }
+    template <size_t... I>
+    void destroyRows(size_type first, size_type last, soa_detail::index_sequence<I...>)
+    {
+        int expand[] = {0, (destroyColumn(std::get<I>(columns_), first, last), 0)...};
+        (void)expand;
+    }
+
+    //在未初始化的第n行移动构造tmp的各个字段
+    template <size_t... I>
+    void moveIntoRow(size_type n, value_type &tmp, soa_detail::index_sequence<I...>)
+    {
+        int expand[] = {0, (::new (static_cast<void *>(std::get<I>(columns_) + n))
+                            typename field<I>::type(std::move(std::get<I>(tmp))), 0)...};
+        (void)expand;
+    }
+
+    //[pos, size_)后移一行，第pos行由val移动赋值
+    template <typename F>
+    static void shiftAndAssign(F *col, size_type pos, size_type size, F &val)
+    {
+        if(pos == size)
+        {
+            ::new (static_cast<void *>(col + size)) F(std::move(val));
+            return;
+        }
+        ::new (static_cast<void *>(col + size)) F(std::move(col[size - 1]));
+        std::move_backward(col + pos, col + size - 1, col + size);
+        col[pos] = std::move(val);
+    }
+    template <size_t... I>
+    void insertRow(size_type pos, value_type &tmp, soa_detail::index_sequence<I...>)
+    {
+        int expand[] = {0, (shiftAndAssign(std::get<I>(columns_), pos, size_, std::get<I>(tmp)), 0)...};
+        (void)expand;
+    }
+
+    template <typename F>
+    static void eraseColumn(F *col, size_type first, size_type last, size_type size)
+    {
+        std::move(col + last, col + size, col + first);
+        destroyColumn(col, size - (last - first), size);
+    }
+    template <size_t... I>
+    void eraseRows(size_type first, size_type last, soa_detail::index_sequence<I...>)
+    {
+        int expand[] = {0, (eraseColumn(std::get<I>(columns_), first, last, size_), 0)...};
+        (void)expand;
+    }
+
+    //对第I列及之后的列值初始化[first, last)，失败时已经构造的部分全部析构
+    template <size_t I>
+    void valueInitColumns(size_type first, size_type last, std::integral_constant<size_t, I>);
+    void valueInitColumns(size_type, size_type, std::integral_constant<size_t, sizeof...(Fields)>) { }
+
+    template <size_t... I>
+    void copyColumns(const SoAVector &other, soa_detail::index_sequence<I...>)
+    {
+        int expand[] = {0, (std::uninitialized_copy(std::get<I>(other.columns_),
+                                                    std::get<I>(other.columns_) + other.size_,
+                                                    std::get<I>(columns_)), 0)...};
+        (void)expand;
+    }
+
+    void grow(size_type n = 1)
+    {
+        if(n > max_size() - size_)
+            throw std::length_error("SoAVector");
+        reserve(GrowDouble::next(cap_, size_ + n, rowBytes(), max_size()));
+    }
+    void uncreate();
+
+    char *buffer_; //所有列共用的内存
+    Columns columns_; //每列的起始位置
+    size_type size_;
+    size_type cap_;
+};
+
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(const SoAVector &other)
+    :buffer_(NULL), size_(0), cap_(0)
+{
+    reserve(other.size_);
+    //拷贝都不抛异常时整列拷贝，否则逐行追加，出错时只需释放已经追加的行
+    if(soa_detail::all_of<std::is_nothrow_copy_constructible<Fields>::value...>::value)
+    {
+        copyColumns(other, Indices());
+        size_ = other.size_;
+        return;
+    }
+    try
+    {
+        for(size_type ix = 0; ix != other.size_; ++ix)
+        {
+            value_type tmp(other[ix]);
+            moveIntoRow(size_, tmp, Indices());
+            ++size_;
+        }
+    }
+    catch(...)
+    {
+        uncreate();
+        throw;
+    }
+}
+
+template <typename... Fields>
+template <typename... Args>
+void SoAVector<Fields...>::emplace_back(Args&&... args)
+{
+    value_type tmp(std::forward<Args>(args)...); //先构造好整行，参数可能引用容器中的元素
+    if(size_ == cap_)
+        grow();
+    moveIntoRow(size_, tmp, Indices());
+    ++size_;
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::iterator
+SoAVector<Fields...>::insert(const_iterator position, const Fields &... fields)
+{
+    size_type pos = position.index();
+    value_type tmp(fields...);
+    if(size_ == cap_)
+        grow();
+    insertRow(pos, tmp, Indices());
+    ++size_;
+    return begin() + pos;
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::iterator
+SoAVector<Fields...>::erase(const_iterator first, const_iterator last)
+{
+    size_type pos = first.index(), stop = last.index();
+    if(pos != stop)
+    {
+        eraseRows(pos, stop, Indices());
+        size_ -= stop - pos;
+    }
+    return begin() + pos;
+}
+
+template <typename... Fields>
+template <size_t I>
+void SoAVector<Fields...>::valueInitColumns(size_type first, size_type last, std::integral_constant<size_t, I>)
+{
+    typedef typename field<I>::type F;
+    F *col = std::get<I>(columns_);
+    size_type ix = first;
+    try
+    {
+        for(; ix != last; ++ix)
+            ::new (static_cast<void *>(col + ix)) F();
+        valueInitColumns(first, last, std::integral_constant<size_t, I + 1>());
+    }
+    catch(...)
+    {
+        destroyColumn(col, first, ix);
+        throw;
+    }
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::resize(size_type n)
+{
+    if(n < size_)
+    {
+        destroyRows(n, size_, Indices());
+        size_ = n;
+    }
+    else if(n > size_)
+    {
+        if(n > cap_)
+            grow(n - size_);
+        valueInitColumns(size_, n, std::integral_constant<size_t, 0>());
+        size_ = n;
+    }
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::reserve(size_type n)
+{
+    if(n <= cap_)
+        return;
+    if(n > max_size())
+        throw std::length_error("SoAVector::reserve");
+
+    void *p = NULL;
+    if(posix_memalign(&p, kColumnAlign, columnOffset(sizeof...(Fields), n)) != 0)
+        throw std::bad_alloc();
+    char *new_buffer = static_cast<char *>(p);
+    Columns new_columns = makeColumns(new_buffer, n, Indices());
+    relocateRows(new_columns, Indices()); //移动不抛异常
+    free(buffer_);
+
+    buffer_ = new_buffer;
+    columns_ = new_columns;
+    cap_ = n;
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::uncreate()
+{
+    if(buffer_ == NULL)
+        return;
+    destroyRows(0, size_, Indices());
+    free(buffer_);
+    buffer_ = NULL;
+    size_ = cap_ = 0;
+}
+
+#endif  /* SOAVECTOR_HPP */
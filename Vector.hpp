@@ -4,35 +4,247 @@
 #include <memory>
 #include <algorithm>
 #include <limits>
+#include <stdexcept>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <thread>
 #include <stddef.h>
+#include <string.h>
+#include "VectorCompare.hpp"
+#include "VectorView.hpp"
+
+//元素能否按字节搬迁：memcpy到新位置后旧对象不再析构
+//默认只有可平凡拷贝的类型满足，用户可以为自己的类型特化
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+//分配器是否提供reallocate(p, old_n, new_n)，用于原地扩展内存
+template <typename Alloc>
+class has_reallocate
+{
+    template <typename A>
+    static auto check(int) -> decltype(std::declval<A &>().reallocate(
+        std::declval<typename A::value_type *>(), size_t(), size_t()), std::true_type());
+    template <typename A>
+    static std::false_type check(...);
+public:
+    static const bool value = decltype(check<Alloc>(0))::value;
+};
+
+//allocate_at_least的返回值：实际得到的内存可能比请求的多
+template <typename Pointer>
+struct allocation_result
+{
+    Pointer ptr;
+    size_t count;
+};
+
+//分配器是否提供allocate_at_least(n)，Vector会把多出来的内存计入容量
+template <typename Alloc>
+class has_allocate_at_least
+{
+    template <typename A>
+    static auto check(int) -> decltype(std::declval<A &>().allocate_at_least(size_t()), std::true_type());
+    template <typename A>
+    static std::false_type check(...);
+public:
+    static const bool value = decltype(check<Alloc>(0))::value;
+};
+
+//增长策略：根据当前容量cap和至少需要的容量required给出新的容量
+//结果不小于required，且不超过max_size，计算过程不会溢出
+//Num/Den是每次扩容的倍数
+template <size_t Num, size_t Den>
+struct GrowByFactor
+{
+    static size_t next(size_t cap, size_t required, size_t /*elem_size*/, size_t max_size)
+    {
+        size_t extra = cap / Den * (Num - Den) + cap % Den * (Num - Den) / Den;
+        size_t grown = (extra > max_size - cap) ? max_size : cap + extra;
+        return std::max(grown, required);
+    }
+};
+
+typedef GrowByFactor<2, 1> GrowDouble;
+typedef GrowByFactor<3, 2> GrowOneAndHalf;
+typedef GrowByFactor<1618, 1000> GrowGolden; //黄金分割比
+
+//在Base的基础上把字节数向上取整到jemalloc的size class
+//分配器本来就会给这么多内存，取整后这部分不再浪费
+template <typename Base = GrowOneAndHalf>
+struct GrowSizeClass
+{
+    static size_t next(size_t cap, size_t required, size_t elem_size, size_t max_size)
+    {
+        size_t n = Base::next(cap, required, elem_size, max_size);
+        if(n > max_size / 2)
+            return n;
+        return std::min(max_size, sizeClass(n * elem_size) / elem_size);
+    }
+
+    //16字节以内是8和16，128字节以内按16递增，之后每翻一倍分成4级
+    static size_t sizeClass(size_t bytes)
+    {
+        if(bytes <= 8)
+            return 8;
+        size_t lg = sizeof(unsigned long) * 8 - 1 - __builtin_clzl(bytes - 1);
+        size_t step = (lg < 6) ? 16 : (size_t(1) << (lg - 2));
+        return (bytes + step - 1) & ~(step - 1);
+    }
+};
+
+//增长策略是否提供shrink(cap, size, elem_size)，提供时Vector在元素减少后按它的结果收缩容量
+template <typename Growth>
+class has_shrink
+{
+    template <typename G>
+    static auto check(int) -> decltype(G::shrink(size_t(), size_t(), size_t()), std::true_type());
+    template <typename G>
+    static std::false_type check(...);
+public:
+    static const bool value = decltype(check<Growth>(0))::value;
+};
+
+//自动收缩：增长按Base，元素少于容量的1/Den时把容量减到元素个数的2倍
+//收缩后元素要翻倍才会再扩容，减半才会再收缩，不会在阈值附近反复分配
+//不超过MinBytes字节的缓冲区不收缩
+template <typename Base = GrowDouble, size_t Den = 4, size_t MinBytes = 4096>
+struct AutoTrim : Base
+{
+    static_assert(Den > 2, "AutoTrim needs Den > 2 for hysteresis");
+
+    static size_t shrink(size_t cap, size_t size, size_t elem_size)
+    {
+        if(cap * elem_size <= MinBytes || size >= cap / Den)
+            return cap;
+        return std::min(cap, std::max(size * 2, MinBytes / elem_size));
+    }
+};
+
+//统计策略：Vector在分配、释放、扩容和搬迁元素时调用这些静态函数
+//默认的NoVectorStats什么也不做，调用全部内联为空；需要统计时见VectorStats.hpp
+struct NoVectorStats
+{
+    static void onAllocate(size_t /*bytes*/, size_t /*capacity*/) { }
+    static void onDeallocate(size_t /*bytes*/) { }
+    static void onRegrow(size_t /*old_capacity*/, size_t /*new_capacity*/) { }
+    static void onRelocate(size_t /*n*/, bool /*copied*/) { }
+};
+
+//并行执行策略：批量构造、拷贝和析构按块分给多个线程
+//threads为0时使用全部硬件线程，每个线程至少处理min_bytes字节，数据太少时不开线程
+struct parallel_policy
+{
+    explicit parallel_policy(unsigned n = 0, size_t bytes = size_t(1) << 20)
+        :threads(n), min_bytes(bytes) { }
+
+    unsigned threads;
+    size_t min_bytes;
+};
+
+const parallel_policy par;
+
+//把[0, n)分成连续的几块，每块在一个线程中调用fn(first, last)，当前线程处理最后一块
+//内存由处理它的线程第一次写入，NUMA系统上页面会分配在该线程所在的节点
+//fn不能抛出异常；创建线程失败时剩下的块由当前线程完成
+template <typename Fn>
+void parallelChunks(const parallel_policy &policy, size_t n, size_t elem_size, Fn fn)
+{
+    size_t threads = policy.threads ? policy.threads : std::thread::hardware_concurrency();
+    size_t min_n = std::max<size_t>(1, policy.min_bytes / elem_size);
+    threads = std::min(threads, n / min_n);
+    if(threads <= 1)
+    {
+        fn(size_t(0), n);
+        return;
+    }
+
+    //第k块从k * chunk + min(k, extra)开始，前extra块各多一个元素
+    size_t chunk = n / threads, extra = n % threads;
+    std::unique_ptr<size_t[]> start(new size_t[threads + 1]);
+    for(size_t k = 0; k <= threads; ++k)
+        start[k] = k * chunk + std::min(k, extra);
+
+    std::unique_ptr<std::thread[]> workers(new std::thread[threads - 1]);
+    size_t spawned = 0;
+    try
+    {
+        for(; spawned != threads - 1; ++spawned)
+            workers[spawned] = std::thread(fn, start[spawned], start[spawned + 1]);
+    }
+    catch(const std::system_error &)
+    {
+    }
+    for(size_t k = spawned; k != threads; ++k)
+        fn(start[k], start[k + 1]);
+    for(size_t k = 0; k != spawned; ++k)
+        workers[k].join();
+}
+
+//迭代器区间的重载要求In不是整数，Vector<int> v(10, 10)才会选择(n, val)版本
+template <typename In>
+struct enable_if_iterator : std::enable_if<!std::is_integral<In>::value> { };
+
+//保存Vector的分配器，空分配器借助EBO不占空间
+template <typename Alloc, bool = std::is_empty<Alloc>::value>
+class VectorAllocHolder : private Alloc
+{
+public:
+    VectorAllocHolder() { }
+    explicit VectorAllocHolder(const Alloc &a) :Alloc(a) { }
+    explicit VectorAllocHolder(Alloc &&a) :Alloc(std::move(a)) { }
+
+    Alloc &get() { return *this; }
+    const Alloc &get() const { return *this; }
+};
+
+template <typename Alloc>
+class VectorAllocHolder<Alloc, false>
+{
+public:
+    VectorAllocHolder() { }
+    explicit VectorAllocHolder(const Alloc &a) :alloc_(a) { }
+    explicit VectorAllocHolder(Alloc &&a) :alloc_(std::move(a)) { }
+
+    Alloc &get() { return alloc_; }
+    const Alloc &get() const { return alloc_; }
+
+private:
+    Alloc alloc_; //内存分配器
+};
 
 //这里声明Vector是一个模板
-template <typename T, typename Alloc>
+template <typename T, typename Alloc, typename Growth, typename Stats>
 class Vector;
 
 //运算符的函数声明
-template <typename T, typename Alloc>
-bool operator==(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-template <typename T, typename Alloc>
-bool operator!=(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-template <typename T, typename Alloc>
-bool operator<(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-template <typename T, typename Alloc>
-bool operator<=(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-template <typename T, typename Alloc>
-bool operator>(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-template <typename T, typename Alloc>
-bool operator>=(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-
-template <typename T, typename Alloc = std::allocator<T> >
-class Vector
-{
-    friend bool operator==<T, Alloc> (const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-    friend bool operator!=<T, Alloc> (const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-    friend bool operator< <T, Alloc> (const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-    friend bool operator<=<T, Alloc> (const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-    friend bool operator> <T, Alloc> (const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
-    friend bool operator>=<T, Alloc> (const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs);
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator==(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator!=(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator<(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator<=(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator>(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator>=(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+//三路比较：lhs < rhs返回负数，相等返回0，否则返回正数
+template <typename T, typename Alloc, typename Growth, typename Stats>
+int compare(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = GrowDouble,
+          typename Stats = NoVectorStats>
+class Vector : private VectorAllocHolder<Alloc>
+{
+    friend bool operator==<T, Alloc, Growth, Stats> (const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+    friend bool operator!=<T, Alloc, Growth, Stats> (const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+    friend bool operator< <T, Alloc, Growth, Stats> (const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+    friend bool operator<=<T, Alloc, Growth, Stats> (const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+    friend bool operator> <T, Alloc, Growth, Stats> (const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
+    friend bool operator>=<T, Alloc, Growth, Stats> (const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs);
 
     class reverse_iterator;
     class const_reverse_iterator;
@@ -51,6 +263,9 @@ public:
     typedef Alloc allocator_type;
 
 private:
+    typedef VectorAllocHolder<Alloc> AllocHolder;
+    typedef std::allocator_traits<Alloc> alloc_traits;
+
     class reverse_iterator
     {
     public:
@@ -137,29 +352,40 @@ private:
 public:
 
     Vector() { create(); }
-    explicit Vector(size_type n, const value_type &val = value_type()) 
+    explicit Vector(const allocator_type &a) :AllocHolder(a) { create(); }
+    explicit Vector(size_type n, const value_type &val = value_type(),
+                    const allocator_type &a = allocator_type())
+        :AllocHolder(a)
     { create(n, val); }
 
-    template <typename In>
-    Vector(In i, In j) //迭代器区间去初始化容器
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    Vector(In i, In j, const allocator_type &a = allocator_type()) //迭代器区间去初始化容器
+        :AllocHolder(a)
     { create(i, j); }
 
     Vector(const Vector &v)
+        :AllocHolder(alloc_traits::select_on_container_copy_construction(v.alloc()))
+    { create(v.begin(), v.end()); }
+    Vector(const Vector &v, const allocator_type &a)
+        :AllocHolder(a)
     { create(v.begin(), v.end()); }
+    Vector(Vector &&v) noexcept //直接接管v的内存，v置为空
+        :AllocHolder(std::move(v.alloc())), data_(v.data_), avail_(v.avail_), limit_(v.limit_)
+    { v.create(); }
+    Vector(Vector &&v, const allocator_type &a);
+    //由多个线程分段填充，每个线程先写自己那一段内存
+    Vector(const parallel_policy &policy, size_type n, const value_type &val = value_type(),
+           const allocator_type &a = allocator_type());
     Vector &operator=(const Vector &v);
+    Vector &operator=(Vector &&v) 
+        noexcept(alloc_traits::propagate_on_container_move_assignment::value);
     ~Vector() { uncreate(); }
 
-    template <typename In>
+    //尽量复用已有的内存，容量不够时才重新分配
+    template <typename In, typename = typename enable_if_iterator<In>::type>
     void assign(In i, In j)
-    {
-        uncreate();
-        create(i, j);
-    }
-    void assign(size_type n, const T &val)
-    {
-        uncreate();
-        create(n, val);
-    }
+    {   assign(i, j, typename std::iterator_traits<In>::iterator_category());  }
+    void assign(size_type n, const T &val);
 
     reference operator[] (size_type n) { return data_[n]; }
     const_reference operator[] (size_type n) const { return data_[n]; }
@@ -173,37 +399,105 @@ public:
     const_reference back() const { return *rbegin(); }
 
     void push_back(const T &t)
+    {   emplace_back(t);    }
+    void push_back(T &&t)
+    {   emplace_back(std::move(t));  }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args)
     {
         if(avail_ == limit_) // full
-            grow();
-        unCheckedAppend(t);
+            growAndEmplaceBack(std::forward<Args>(args)...);
+        else
+            alloc_traits::construct(alloc(), avail_++, std::forward<Args>(args)...);
     }
     void pop_back()
-    {   alloc_.destroy(--avail_);   }
+    {
+        alloc_traits::destroy(alloc(), --avail_);
+        autoTrim();
+    }
 
     void swap(Vector &other)
     {
+        if(!alloc_traits::propagate_on_container_swap::value && alloc() != other.alloc())
+        {
+            swapElements(other); //不能交换内存，只能交换元素
+            return;
+        }
+        if(alloc_traits::propagate_on_container_swap::value)
+        {
+            using std::swap;
+            swap(alloc(), other.alloc());
+        }
         std::swap(data_, other.data_);
         std::swap(avail_, other.avail_);
         std::swap(limit_, other.limit_);
     }
 
-    iterator insert (iterator position, const value_type& val);
+    template <typename... Args>
+    iterator emplace (iterator position, Args&&... args);
+
+    iterator insert (iterator position, const value_type& val)
+    {   return emplace(position, val);  }
+    iterator insert (iterator position, value_type&& val)
+    {   return emplace(position, std::move(val));   }
     void insert (iterator position, size_type n, const value_type& val);
-    template <typename InputIterator>
-    void insert (iterator position, InputIterator first, InputIterator last);
+    template <typename InputIterator, typename = typename enable_if_iterator<InputIterator>::type>
+    void insert (iterator position, InputIterator first, InputIterator last)
+    {
+        insert(position, first, last, 
+               typename std::iterator_traits<InputIterator>::iterator_category());
+    }
 
     iterator erase (iterator position);
     iterator erase (iterator first, iterator last);
+    void clear() { erase(begin(), end()); }
+
+    //批量删除：一次遍历把留下的元素前移，最后只析构一次末尾，代替逐个erase的O(n^2)循环
+    //删除满足pred的元素，留下的元素保持原来的顺序，返回删除的个数
+    template <typename Pred>
+    size_type erase_if(Pred pred);
+    //删除[first, last)给出的下标，下标要升序且小于size()，重复的下标只删除一次，需要前向迭代器
+    //下标不合法时抛出out_of_range，容器不变
+    template <typename In, typename = typename enable_if_iterator<In>::type>
+    size_type remove_indices(In first, In last);
+    //把最后一个元素移到position，不保持顺序，O(1)；返回position
+    iterator swap_erase(iterator position);
 
     void resize (size_type n, value_type val = value_type());
     void reserve (size_type n);
+    //把容量减到size()，为空时释放内存；元素搬迁的方式同扩容
+    void shrink_to_fit();
+
+    //在末尾追加n个val，容量不够时只扩容一次，元素一次构造完成
+    void append_n(size_type n, const value_type &val);
+    //新增的元素默认初始化：可平凡构造的类型不写内存，内容不确定，适合马上被read()覆盖的缓冲区
+    void resize_default_init(size_type n);
+    //同resize_default_init，但要求元素可平凡构造和析构，编译期保证不会有任何初始化
+    void resize_uninitialized(size_type n);
+    //容量至少为n，调用op(data(), n)直接写内存，op返回最终的元素个数（不超过n）
+    //[0, size())保持原样，其余位置未初始化；op抛出异常时size()不变
+    template <typename Op>
+    void resize_and_overwrite(size_type n, Op op);
+
+    //并行版本：大块的构造、拷贝和析构分给多个线程，分配器必须能被多个线程同时使用
+    //元素的拷贝构造可能抛异常时退化为串行版本
+    void copy_from(const parallel_policy &policy, const Vector &other); //相当于assign(other.begin(), other.end())
+    void resize(const parallel_policy &policy, size_type n, value_type val = value_type());
+    void clear(const parallel_policy &policy); //析构全部元素，保留内存
 
     bool empty() const { return data_ == avail_; }
     size_type size() const { return avail_ - data_; }
     size_type capacity() const { return limit_ - data_; }
     size_type max_size() const 
-    { return std::numeric_limits<size_type>::max() / sizeof(T); }
+    {
+        return std::min<size_type>(alloc_traits::max_size(alloc()),
+            std::numeric_limits<difference_type>::max() / sizeof(T));
+    }
+
+    //指向第一个元素的指针，容器为空时可能是NULL；对齐方式由分配器决定，见AlignedAllocator
+    T *data() { return data_; }
+    const T *data() const { return data_; }
 
     iterator begin() { return data_; }
     iterator end() { return avail_; }
@@ -218,113 +512,465 @@ public:
     { return const_reverse_iterator(data_); }
 
     allocator_type get_allocator() const
-    { return alloc_; }
-
-private:
+    { return alloc(); }
+
+    //共享存储的视图，不拷贝元素；pos超过size()时抛出out_of_range
+    VectorView<T> slice(size_type pos, size_type len = VectorView<T>::npos)
+    {   return VectorView<T>(*this).slice(pos, len);  }
+    VectorView<const T> slice(size_type pos, size_type len = VectorView<T>::npos) const
+    {   return VectorView<const T>(*this).slice(pos, len);    }
+
+    //接管p处的内存：[p, p + n)是已经构造好的元素，共cap个元素的内存
+    //这块内存必须能用当前的分配器释放，原有的元素和内存先被释放
+    void adopt(pointer p, size_type n, size_type cap);
+    //交出内存，容器变为空；调用者负责析构之前的size()个元素，并用分配器释放capacity()个元素的内存
+    pointer release();
+
+protected:
+    //派生的容器（如SmallVectorImpl）需要直接管理内存
     iterator data_; //数组的首元素
     iterator avail_; //最后一个元素的下一个位置
     iterator limit_; //最后一块内存的下一个位置
 
-    std::allocator<T> alloc_; //内存分配器
+    Alloc &alloc() { return AllocHolder::get(); }
+    const Alloc &alloc() const { return AllocHolder::get(); }
 
     //为底层的数组开辟内存空间，并执行相应的初始化
     void create();
     void create(size_type, const value_type &);
     template <typename In>
-    void create(In, In);
+    void create(In i, In j)
+    {   create(i, j, typename std::iterator_traits<In>::iterator_category());  }
+    template <typename In>
+    void create(In, In, std::input_iterator_tag); //逐个追加
+    template <typename In>
+    void create(In, In, std::forward_iterator_tag); //先求长度，只分配一次
 
     //删除数组中的元素，并且释放内存
     void uncreate();
 
-    //用于push_back函数
-    void grow();
+private:
+    //申请至少n个元素的内存，n被改为实际得到的数量
+    iterator allocateAtLeast(size_type &n)
+    {
+        iterator p = allocateAtLeast(n, 
+            std::integral_constant<bool, has_allocate_at_least<Alloc>::value>());
+        Stats::onAllocate(n * sizeof(T), n);
+        return p;
+    }
+    iterator allocateAtLeast(size_type &n, std::true_type)
+    {
+        allocation_result<iterator> result = alloc().allocate_at_least(n);
+        n = result.count;
+        return result.ptr;
+    }
+    iterator allocateAtLeast(size_type &n, std::false_type)
+    {   return alloc_traits::allocate(alloc(), n);  }
+    //释放p开始的n个元素的内存
+    void deallocate(iterator p, size_type n)
+    {
+        if(p != NULL)
+            Stats::onDeallocate(n * sizeof(T));
+        alloc_traits::deallocate(alloc(), p, n);
+    }
+
+    void swapElements(Vector &other);
+
+    //增长策略提供shrink时，元素减少后按它的结果收缩容量；收缩失败时保持原样
+    void autoTrim()
+    {   autoTrim(std::integral_constant<bool, has_shrink<Growth>::value>());  }
+    void autoTrim(std::false_type) { }
+    void autoTrim(std::true_type);
+    //把容量改为n，n不小于size()
+    void shrinkTo(size_type n);
+
+    //在[first, last)上默认初始化元素
+    void defaultInit(iterator, iterator, std::true_type) { }
+    void defaultInit(iterator first, iterator last, std::false_type);
+
+    template <typename In>
+    void assign(In, In, std::input_iterator_tag);
+    template <typename In>
+    void assign(In, In, std::forward_iterator_tag);
+    template <typename In>
+    void insert(iterator, In, In, std::input_iterator_tag);
+    template <typename In>
+    void insert(iterator, In, In, std::forward_iterator_tag);
+
+    //用于push_back函数，保证还能再插入n个元素
+    void grow(size_type n = 1);
+    //由增长策略计算新的容量，超过max_size时抛出length_error
+    size_type recommend(size_type required) const;
     void unCheckedAppend(const value_type &);
+    //先在新内存中构造元素，再迁移旧元素，args可能引用容器中的元素
+    template <typename... Args>
+    void growAndEmplaceBack(Args&&... args);
 
     //
     void growToN(size_type n);
+    void growToN(size_type n, std::true_type); //reallocate原地扩展
+    void growToN(size_type n, std::false_type); //申请新内存后搬迁
+
+    //在未初始化的[dest, dest + n)中并行构造val的副本，要求拷贝构造不抛异常
+    void parallelFill(const parallel_policy &policy, iterator dest, size_type n, const value_type &val);
+    void parallelDestroy(const parallel_policy &policy, iterator first, iterator last);
+
+    //把[first, last)搬到未初始化的dest处，移动构造不抛异常时移动，否则拷贝
+    static iterator uninitializedMove(iterator first, iterator last, iterator dest);
+    //把[first, last)搬到未初始化的dest处，并结束旧对象的生命期
+    iterator relocate(iterator first, iterator last, iterator dest);
+    //按字节把[first, last)搬到dest，区间可以重叠
+    static void memmoveRange(iterator first, iterator last, iterator dest);
+
+    //erase_if的压缩内核，返回留下的元素的末尾
+    //算术类型和指针每个元素都写到out，只根据pred决定out是否前进，循环里没有分支
+    template <typename Pred>
+    iterator compact(Pred &pred, std::true_type);
+    template <typename Pred>
+    iterator compact(Pred &pred, std::false_type);
+    //按字节搬迁的类型：删除的元素就地析构，留下的直接memcpy，不需要移动赋值
+    template <typename Pred>
+    iterator compactRelocatable(Pred &pred);
 };
 
-template <typename T, typename Alloc>
-Vector<T, Alloc> &Vector<T, Alloc>::operator=(const Vector &rhs)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+Vector<T, Alloc, Growth, Stats>::Vector(Vector &&v, const allocator_type &a)
+    :AllocHolder(a)
 {
-    if(this != &rhs)
+    if(alloc() == v.alloc())
     {
-        uncreate();
+        data_ = v.data_;
+        avail_ = v.avail_;
+        limit_ = v.limit_;
+        v.create();
+    }
+    else //分配器不同，不能接管内存，只能逐个移动
+        create(std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+Vector<T, Alloc, Growth, Stats>::Vector(const parallel_policy &policy, size_type n, const value_type &val,
+                                        const allocator_type &a)
+    :AllocHolder(a)
+{
+    if(!std::is_nothrow_copy_constructible<T>::value)
+    {
+        create(n, val);
+        return;
+    }
+    size_type cap = n;
+    data_ = allocateAtLeast(cap);
+    parallelFill(policy, data_, n, val);
+    avail_ = data_ + n;
+    limit_ = data_ + cap;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+Vector<T, Alloc, Growth, Stats> &Vector<T, Alloc, Growth, Stats>::operator=(const Vector &rhs)
+{
+    if(this == &rhs)
+        return *this;
+
+    if(alloc_traits::propagate_on_container_copy_assignment::value && alloc() != rhs.alloc())
+    {
+        uncreate(); //先用原来的分配器释放
+        alloc() = rhs.alloc();
         create(rhs.begin(), rhs.end());
     }
+    else
+        assign(rhs.begin(), rhs.end()); //复用已有的内存
     return *this;
 }
 
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::assign(size_type n, const T &val)
+{
+    if(n > capacity())
+    {
+        const value_type tmp(val); //val可能引用容器中的元素
+        uncreate();
+        create(n, tmp);
+    }
+    else if(n <= size())
+    {
+        std::fill_n(data_, n, val);
+        erase(data_ + n, avail_);
+    }
+    else
+    {
+        std::fill(data_, avail_, val);
+        avail_ = std::uninitialized_fill_n(avail_, n - size(), val);
+    }
+}
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::create()
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename In>
+void Vector<T, Alloc, Growth, Stats>::assign(In first, In last, std::input_iterator_tag)
+{
+    //先覆盖已有的元素，多余的删除，不够的追加
+    iterator cur = data_;
+    for(; first != last && cur != avail_; ++first, ++cur)
+        *cur = *first;
+    if(first == last)
+        erase(cur, avail_);
+    else
+        for(; first != last; ++first)
+            emplace_back(*first);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename In>
+void Vector<T, Alloc, Growth, Stats>::assign(In first, In last, std::forward_iterator_tag)
+{
+    size_type n = std::distance(first, last);
+    if(n > capacity())
+    {
+        uncreate();
+        create(first, last, std::forward_iterator_tag());
+    }
+    else if(n <= size())
+        erase(std::copy(first, last, data_), avail_);
+    else
+    {
+        In mid = first;
+        std::advance(mid, size());
+        std::copy(first, mid, data_);
+        avail_ = std::uninitialized_copy(mid, last, avail_);
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+Vector<T, Alloc, Growth, Stats> &Vector<T, Alloc, Growth, Stats>::operator=(Vector &&rhs)
+    noexcept(alloc_traits::propagate_on_container_move_assignment::value)
+{
+    if(this == &rhs)
+        return *this;
+
+    if(!alloc_traits::propagate_on_container_move_assignment::value && alloc() != rhs.alloc())
+    {
+        //分配器不同，不能接管内存，只能逐个移动
+        uncreate();
+        create(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+    }
+    else
+    {
+        uncreate();
+        if(alloc_traits::propagate_on_container_move_assignment::value)
+            alloc() = std::move(rhs.alloc());
+        data_ = rhs.data_;
+        avail_ = rhs.avail_;
+        limit_ = rhs.limit_;
+        rhs.create();
+    }
+    return *this;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::adopt(pointer p, size_type n, size_type cap)
+{
+    if(p == data_)
+        return;
+    uncreate();
+    //所有权的转移也计入统计，接管后释放时bytes_freed与bytes_allocated保持一致
+    if(p != NULL)
+        Stats::onAllocate(cap * sizeof(T), cap);
+    data_ = p;
+    avail_ = p + n;
+    limit_ = p + cap;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+typename Vector<T, Alloc, Growth, Stats>::pointer Vector<T, Alloc, Growth, Stats>::release()
+{
+    pointer p = data_;
+    if(p != NULL)
+        Stats::onDeallocate(capacity() * sizeof(T));
+    create();
+    return p;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::swapElements(Vector &other)
+{
+    Vector &shorter = size() < other.size() ? *this : other;
+    Vector &longer = size() < other.size() ? other : *this;
+    size_type n = shorter.size();
+    std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+    shorter.insert(shorter.end(), std::make_move_iterator(longer.begin() + n),
+                   std::make_move_iterator(longer.end()));
+    longer.erase(longer.begin() + n, longer.end());
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::create()
 {
     data_ = avail_ = limit_ = NULL;
 }
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::create(size_type n, const value_type &val)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::create(size_type n, const value_type &val)
 {
     //分配内存
-    data_ = alloc_.allocate(n);
+    size_type cap = n;
+    data_ = allocateAtLeast(cap);
     //执行构造函数 拷贝构造函数
     std::uninitialized_fill(data_, data_ + n, val);
-    avail_ = limit_ = data_ + n;
+    avail_ = data_ + n;
+    limit_ = data_ + cap;
 
     //为什么不使用new？
 }
 
 
-template <typename T, typename Alloc>
+template <typename T, typename Alloc, typename Growth, typename Stats>
 template <typename In>
-void Vector<T, Alloc>::create(In i, In j)
+void Vector<T, Alloc, Growth, Stats>::create(In i, In j, std::input_iterator_tag)
+{
+    //长度未知，按增长策略逐个追加
+    create();
+    for(; i != j; ++i)
+        emplace_back(*i);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename In>
+void Vector<T, Alloc, Growth, Stats>::create(In i, In j, std::forward_iterator_tag)
 {
     //分配内存
-    data_ = alloc_.allocate(j-i);
+    size_type cap = std::distance(i, j);
+    if(cap > max_size())
+        throw std::length_error("Vector");
+    data_ = allocateAtLeast(cap);
     //执行构造函数 copy
-    avail_ = limit_ = std::uninitialized_copy(i, j, data_);
+    avail_ = std::uninitialized_copy(i, j, data_);
+    limit_ = data_ + cap;
 }
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::uncreate()
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::uncreate()
 {
     //先执行析构函数
     if(data_)
     {
         iterator it(avail_); //初始
         while(it != data_)
-            alloc_.destroy(--it);
+            alloc_traits::destroy(alloc(), --it);
     }
 
     //释放内存
-    alloc_.deallocate(data_, limit_ - data_);
+    deallocate(data_, limit_ - data_);
 
     data_ = limit_ = avail_ = NULL;
 }
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::grow()
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::grow(size_type n)
 {
-    //确定size
-    size_type new_size = std::max(2*(limit_ - data_), difference_type(1));
+    if(n > max_size() - size())
+        throw std::length_error("Vector::grow");
+    //确定size，一次到位
+    growToN(recommend(size() + n));
+}
 
-    growToN(new_size);
+template <typename T, typename Alloc, typename Growth, typename Stats>
+typename Vector<T, Alloc, Growth, Stats>::size_type Vector<T, Alloc, Growth, Stats>::recommend(size_type required) const
+{
+    size_type max = max_size();
+    if(required > max)
+        throw std::length_error("Vector");
+    return Growth::next(capacity(), required, sizeof(T), max);
 }
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::unCheckedAppend(const value_type &val)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::unCheckedAppend(const value_type &val)
 {
-    alloc_.construct(avail_++, val); //插入新的元素
+    alloc_traits::construct(alloc(), avail_++, val); //插入新的元素
 }
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::growToN(size_type n)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename... Args>
+void Vector<T, Alloc, Growth, Stats>::growAndEmplaceBack(Args&&... args)
 {
-    //申请内存并构造
-    iterator new_data = alloc_.allocate(n);
-    iterator new_avail = std::uninitialized_copy(data_, avail_, new_data);
-    //析构并释放之前的内存
-    uncreate();
+    if(size() == max_size())
+        throw std::length_error("Vector::push_back");
+    size_type new_size = recommend(size() + 1);
+    if(is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value)
+    {
+        //reallocate可能移动内存，先构造好新元素
+        value_type tmp(std::forward<Args>(args)...);
+        growToN(new_size);
+        alloc_traits::construct(alloc(), avail_++, std::move(tmp));
+        return;
+    }
+
+    Stats::onRegrow(capacity(), new_size);
+    iterator new_data = allocateAtLeast(new_size);
+    iterator new_avail = new_data + size();
+    try
+    {
+        alloc_traits::construct(alloc(), new_avail, std::forward<Args>(args)...);
+    }
+    catch(...)
+    {
+        deallocate(new_data, new_size);
+        throw;
+    }
+    try
+    {
+        relocate(data_, avail_, new_data);
+    }
+    catch(...)
+    {
+        alloc_traits::destroy(alloc(), new_avail);
+        deallocate(new_data, new_size);
+        throw;
+    }
+    deallocate(data_, limit_ - data_);
+
+    data_ = new_data;
+    avail_ = new_avail + 1;
+    limit_ = data_ + new_size;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::growToN(size_type n)
+{
+    Stats::onRegrow(capacity(), n);
+    growToN(n, std::integral_constant<bool,
+        is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value>());
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::growToN(size_type n, std::true_type)
+{
+    //由分配器决定原地扩展还是换一块内存，元素按字节随之搬迁
+    size_type len = size();
+    if(data_ != NULL)
+        Stats::onDeallocate(capacity() * sizeof(T));
+    data_ = alloc().reallocate(data_, capacity(), n);
+    Stats::onAllocate(n * sizeof(T), n);
+    Stats::onRelocate(len, false);
+    avail_ = data_ + len;
+    limit_ = data_ + n;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::growToN(size_type n, std::false_type)
+{
+    //申请内存并迁移元素
+    iterator new_data = allocateAtLeast(n);
+    iterator new_avail;
+    try
+    {
+        new_avail = relocate(data_, avail_, new_data);
+    }
+    catch(...)
+    {
+        deallocate(new_data, n);
+        throw;
+    }
+    //旧元素已经搬走，只需释放之前的内存
+    deallocate(data_, limit_ - data_);
 
     //重置指针
     data_ = new_data;
@@ -333,37 +979,134 @@ void Vector<T, Alloc>::growToN(size_type n)
 }
 
 
-template <typename T, typename Alloc>
-typename Vector<T, Alloc>::iterator Vector<T, Alloc>::insert(iterator position, const value_type& val)
+//把[first, last)搬到未初始化的dest处，等价于对每个元素使用std::move_if_noexcept：
+//移动构造不抛异常时移动，否则拷贝，拷贝失败时原来的元素不受影响
+//GapVector、RingVector等扩容时也用它
+template <typename T>
+T *uninitializedMoveIfNoexcept(T *first, T *last, T *dest)
+{
+    typedef typename std::conditional<
+        !std::is_nothrow_move_constructible<T>::value && std::is_copy_constructible<T>::value,
+        T *, std::move_iterator<T *> >::type Iter;
+    return std::uninitialized_copy(Iter(first), Iter(last), dest);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+typename Vector<T, Alloc, Growth, Stats>::iterator 
+Vector<T, Alloc, Growth, Stats>::uninitializedMove(iterator first, iterator last, iterator dest)
+{
+    return uninitializedMoveIfNoexcept(first, last, dest);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+typename Vector<T, Alloc, Growth, Stats>::iterator 
+Vector<T, Alloc, Growth, Stats>::relocate(iterator first, iterator last, iterator dest)
+{
+    Stats::onRelocate(last - first, !is_trivially_relocatable<T>::value
+        && !std::is_nothrow_move_constructible<T>::value && std::is_copy_constructible<T>::value);
+    if(is_trivially_relocatable<T>::value)
+    {
+        //一次memcpy，旧对象不必析构
+        if(first != last)
+            memcpy(static_cast<void *>(dest), static_cast<const void *>(first), (last - first) * sizeof(T));
+        return dest + (last - first);
+    }
+
+    iterator new_last = uninitializedMove(first, last, dest);
+    while(first != last)
+        alloc_traits::destroy(alloc(), first++);
+    return new_last;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::memmoveRange(iterator first, iterator last, iterator dest)
+{
+    if(first != last)
+        memmove(static_cast<void *>(dest), static_cast<const void *>(first), (last - first) * sizeof(T));
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename... Args>
+typename Vector<T, Alloc, Growth, Stats>::iterator Vector<T, Alloc, Growth, Stats>::emplace(iterator position, Args&&... args)
 {
     difference_type pos = position - data_; //防止失效
-    insert(position, 1, val);
-    return position + pos;
+    if(position == avail_)
+    {
+        emplace_back(std::forward<Args>(args)...);
+        return data_ + pos;
+    }
+
+    value_type tmp(std::forward<Args>(args)...); //args可能引用容器中的元素
+    if(avail_ == limit_)
+        grow();
+    position = data_ + pos;
+
+    if(is_trivially_relocatable<T>::value)
+    {
+        //整体按字节后移一位，在空出的位置上构造
+        memmoveRange(position, avail_, position + 1);
+        try
+        {
+            alloc_traits::construct(alloc(), position, std::move(tmp));
+        }
+        catch(...)
+        {
+            memmoveRange(position + 1, avail_ + 1, position);
+            throw;
+        }
+        ++avail_;
+        return position;
+    }
+
+    //最后一个元素后移到未初始化的内存，其余的依次后移一位
+    alloc_traits::construct(alloc(), avail_, std::move(*(avail_ - 1)));
+    std::move_backward(position, avail_ - 1, avail_);
+    ++avail_;
+    *position = std::move(tmp);
+    return position;
 }
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::insert(iterator position, size_type n, const value_type& val)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::insert(iterator position, size_type n, const value_type& value)
 {
+    const value_type val(value); //value可能引用容器中的元素
     difference_type pos = position - data_; //防止position失效
-    while(static_cast<size_type>(limit_ - avail_) < n)
-        grow();
+    if(static_cast<size_type>(limit_ - avail_) < n)
+        grow(n);
     position = data_ + pos;
 
+    if(is_trivially_relocatable<T>::value)
+    {
+        //尾部整体按字节后移n位，空出的位置直接构造
+        memmoveRange(position, avail_, position + n);
+        try
+        {
+            std::uninitialized_fill_n(position, n, val);
+        }
+        catch(...)
+        {
+            memmoveRange(position + n, avail_ + n, position);
+            throw;
+        }
+        avail_ = avail_ + n;
+        return;
+    }
+
     size_type left = avail_ - position; //从pos到最后的元素数量
     if(n < left) 
     {
         //元素后移n位
         size_type len = avail_ - position; //需要移动的数量
         size_type len_copy = len - n; //需要复制的数量
-        std::uninitialized_copy(position + len_copy, avail_, avail_);
-        std::copy_backward(position, position + len_copy, avail_);
+        uninitializedMove(position + len_copy, avail_, avail_);
+        std::move_backward(position, position + len_copy, avail_);
         //fill
         std::fill_n(position, n, val);
     }
     else if(n > left)
     {
         //所有的元素后移
-        std::uninitialized_copy(position, avail_, position + n);
+        uninitializedMove(position, avail_, position + n);
 
         //对新元素分两次处理
         std::fill_n(position, avail_ - position, val);
@@ -371,52 +1114,83 @@ void Vector<T, Alloc>::insert(iterator position, size_type n, const value_type&
     }
     else
     {
-        std::uninitialized_copy(position, avail_, avail_);
+        uninitializedMove(position, avail_, avail_);
         std::fill_n(position, n, val);
     }
 
     avail_ = avail_ + n; //重置指针
 }
 
-template <typename T, typename Alloc>
-template <typename InputIterator>
-void Vector<T, Alloc>::insert(iterator position, InputIterator first, InputIterator last)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename In>
+void Vector<T, Alloc, Growth, Stats>::insert(iterator position, In first, In last, std::input_iterator_tag)
+{
+    //只能遍历一次：先追加到末尾，再旋转到position
+    difference_type pos = position - data_;
+    difference_type old_size = size();
+    for(; first != last; ++first)
+        emplace_back(*first);
+    std::rotate(data_ + pos, data_ + old_size, avail_);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename In>
+void Vector<T, Alloc, Growth, Stats>::insert(iterator position, In first, In last, std::forward_iterator_tag)
 {
     difference_type pos = position - data_; //防止position失效
-    size_type n = last - first; //需要插入的元素
-    //这里必须使用while，防止一次增加不够
-    while(static_cast<size_type>(limit_ - avail_) < n)
-        grow();
+    size_type n = std::distance(first, last); //需要插入的元素
+    //一次计算出目标容量，只重新分配一次
+    if(static_cast<size_type>(limit_ - avail_) < n)
+        grow(n);
 
     position = data_ + pos;
     //std::copy(first, last, position);
 
+    if(is_trivially_relocatable<T>::value)
+    {
+        //尾部整体按字节后移n位，空出的位置直接构造
+        memmoveRange(position, avail_, position + n);
+        try
+        {
+            std::uninitialized_copy(first, last, position);
+        }
+        catch(...)
+        {
+            memmoveRange(position + n, avail_ + n, position);
+            throw;
+        }
+        avail_ = avail_ + n;
+        return;
+    }
+
     size_type left = avail_ - position; //从pos到最后的元素数量
     if(n < left) 
     {
         //元素后移n位
         size_type len = avail_ - position; //需要移动的数量
         size_type len_copy = len - n; //需要复制的数量
-        std::uninitialized_copy(position + len_copy, avail_, avail_);
-        std::copy_backward(position, position + len_copy, avail_);
+        uninitializedMove(position + len_copy, avail_, avail_);
+        std::move_backward(position, position + len_copy, avail_);
         //copy
         std::copy(first, last, position);
     }
     else if(n > left)
     {
         //所有的元素后移
-        std::uninitialized_copy(position, avail_, position + n);
+        uninitializedMove(position, avail_, position + n);
 
         //对新元素分两次处理
         //std::fill_n(position, avail_ - position, val);
         //std::uninitialized_fill(avail_, position + n, val);
 
-        std::copy(first, first + left, position);
-        std::uninitialized_copy(first + left, last, avail_);
+        In mid = first;
+        std::advance(mid, left);
+        std::copy(first, mid, position);
+        std::uninitialized_copy(mid, last, avail_);
     }
     else
     {
-        std::uninitialized_copy(position, avail_, avail_);
+        uninitializedMove(position, avail_, avail_);
         //std::fill_n(position, avail_ - position, val);
         std::copy(first, last, position);
     }
@@ -424,37 +1198,188 @@ void Vector<T, Alloc>::insert(iterator position, InputIterator first, InputItera
     avail_ = avail_ + n; //重置指针
 }
 
-template <typename T, typename Alloc>
-typename Vector<T, Alloc>::iterator Vector<T, Alloc>::erase (iterator position)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+typename Vector<T, Alloc, Growth, Stats>::iterator Vector<T, Alloc, Growth, Stats>::erase (iterator position)
 {
-    //不能开头析构函数
-    //[position + 1, avail_)之间的元素前移
-    std::copy(position + 1, avail_, position);
-    //析构最后的元素
-    alloc_.destroy(--avail_);
-    return position; 
+    if(is_trivially_relocatable<T>::value)
+    {
+        //先析构，再把后面的元素按字节前移
+        alloc_traits::destroy(alloc(), position);
+        memmoveRange(position + 1, avail_, position);
+        --avail_;
+    }
+    else
+    {
+        //不能开头析构函数
+        //[position + 1, avail_)之间的元素前移
+        std::move(position + 1, avail_, position);
+        //析构最后的元素
+        alloc_traits::destroy(alloc(), --avail_);
+    }
+    difference_type pos = position - data_; //收缩后position失效
+    autoTrim();
+    return data_ + pos;
 }
 
-template <typename T, typename Alloc>
-typename Vector<T, Alloc>::iterator Vector<T, Alloc>::erase(iterator first, iterator last)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+typename Vector<T, Alloc, Growth, Stats>::iterator Vector<T, Alloc, Growth, Stats>::erase(iterator first, iterator last)
 {
     difference_type left = avail_ - last;
-    //first last avail 向前迁移元素
-    std::copy(last, avail_, first);
+    if(is_trivially_relocatable<T>::value)
+    {
+        for(iterator it = first; it != last; ++it)
+            alloc_traits::destroy(alloc(), it);
+        memmoveRange(last, avail_, first);
+        avail_ = first + left;
+    }
+    else
+    {
+        //first last avail 向前迁移元素
+        std::move(last, avail_, first);
+
+        //析构后面剩余的对象
+        iterator it(first + left);
+        while(avail_ != it)
+        {
+            alloc_traits::destroy(alloc(), --avail_); 
+        }
+    }
+
+    difference_type pos = first - data_; //收缩后first失效
+    autoTrim();
+    return data_ + pos;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename Pred>
+typename Vector<T, Alloc, Growth, Stats>::size_type Vector<T, Alloc, Growth, Stats>::erase_if(Pred pred)
+{
+    size_type old_size = size();
+    iterator stop = compact(pred, std::integral_constant<bool,
+        std::is_arithmetic<T>::value || std::is_pointer<T>::value>());
+    erase(stop, avail_); //compact可能修改avail_，要在它之后读取
+    return old_size - size();
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename Pred>
+typename Vector<T, Alloc, Growth, Stats>::iterator Vector<T, Alloc, Growth, Stats>::compact(Pred &pred, std::false_type)
+{
+    if(!is_trivially_relocatable<T>::value)
+        return std::remove_if(data_, avail_, pred);
+    avail_ = compactRelocatable(pred); //删除的元素已经析构
+    return avail_;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename Pred>
+typename Vector<T, Alloc, Growth, Stats>::iterator Vector<T, Alloc, Growth, Stats>::compact(Pred &pred, std::true_type)
+{
+    iterator out = data_;
+    for(iterator it = data_; it != avail_; ++it)
+    {
+        value_type v = *it;
+        *out = v;
+        out += !pred(v);
+    }
+    return out;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename Pred>
+typename Vector<T, Alloc, Growth, Stats>::iterator Vector<T, Alloc, Growth, Stats>::compactRelocatable(Pred &pred)
+{
+    iterator out = data_, it = data_;
+    try
+    {
+        for(; it != avail_; ++it)
+        {
+            if(pred(*it))
+                alloc_traits::destroy(alloc(), it);
+            else
+            {
+                if(out != it)
+                    memcpy(static_cast<void *>(out), static_cast<const void *>(it), sizeof(T));
+                ++out;
+            }
+        }
+    }
+    catch(...)
+    {
+        //*it还没有处理，把剩下的元素接到out后面
+        memmoveRange(it, avail_, out);
+        avail_ = out + (avail_ - it);
+        throw;
+    }
+    return out;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename In, typename>
+typename Vector<T, Alloc, Growth, Stats>::size_type Vector<T, Alloc, Growth, Stats>::remove_indices(In first, In last)
+{
+    //先检查全部下标再修改，要遍历两次
+    static_assert(std::is_base_of<std::forward_iterator_tag,
+                      typename std::iterator_traits<In>::iterator_category>::value,
+                  "remove_indices requires forward iterators");
+    if(first == last)
+        return 0;
+    size_type prev = *first;
+    for(In it = first; it != last; ++it)
+    {
+        size_type ix = *it;
+        if(ix >= size() || ix < prev)
+            throw std::out_of_range("Vector::remove_indices");
+        prev = ix;
+    }
 
-    //析构后面剩余的对象
-    iterator it(first + left);
-    while(avail_ != it)
+    //留下的元素是下标之间的一段段，依次前移到out
+    const bool relocatable = is_trivially_relocatable<T>::value;
+    size_type old_size = size();
+    prev = *first;
+    iterator out = data_ + prev;
+    if(relocatable)
+        alloc_traits::destroy(alloc(), out);
+    for(++first; first != last; ++first)
+    {
+        size_type ix = *first;
+        if(ix == prev)
+            continue;
+        if(relocatable)
+        {
+            alloc_traits::destroy(alloc(), data_ + ix);
+            memmoveRange(data_ + prev + 1, data_ + ix, out);
+            out += ix - prev - 1;
+        }
+        else
+            out = std::move(data_ + prev + 1, data_ + ix, out);
+        prev = ix;
+    }
+    if(relocatable)
     {
-        alloc_.destroy(--avail_); 
+        memmoveRange(data_ + prev + 1, avail_, out);
+        avail_ = out + (avail_ - (data_ + prev + 1));
+        autoTrim();
     }
+    else
+        erase(std::move(data_ + prev + 1, avail_, out), avail_);
+    return old_size - size();
+}
 
-    //不必重置指针
-    return first;
+template <typename T, typename Alloc, typename Growth, typename Stats>
+typename Vector<T, Alloc, Growth, Stats>::iterator Vector<T, Alloc, Growth, Stats>::swap_erase(iterator position)
+{
+    iterator last = avail_ - 1;
+    if(position != last)
+        *position = std::move(*last);
+    alloc_traits::destroy(alloc(), --avail_);
+    difference_type pos = position - data_;
+    autoTrim();
+    return data_ + pos;
 }
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::resize (size_type n, value_type val)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::resize (size_type n, value_type val)
 {
     size_type current_size = size();
     if(n < current_size) //缩小数量
@@ -462,84 +1387,256 @@ void Vector<T, Alloc>::resize (size_type n, value_type val)
         size_type diff = current_size - n;
         while(diff--)
         {
-            alloc_.destroy(--avail_); //pop_back()
+            alloc_traits::destroy(alloc(), --avail_); //pop_back()
         }
+        autoTrim();
     }
     else if(n > current_size) //扩充元素
     {
-        //调用insert来完成内存调整
-        size_type diff = n - current_size;
-        size_type left = static_cast<size_type>(limit_ - avail_); //剩余
-        if(left < diff) //需要重新分配内存 不需要while
-        {
-            growToN(n);
-        }
+        append_n(n - current_size, val); //val是拷贝，扩容后仍然有效
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::append_n(size_type n, const value_type &val)
+{
+    if(n <= static_cast<size_type>(limit_ - avail_))
+    {
+        avail_ = std::uninitialized_fill_n(avail_, n, val);
+        return;
+    }
+    if(n > max_size() - size())
+        throw std::length_error("Vector::append_n");
+    const value_type tmp(val); //val可能引用容器中的元素
+    growToN(recommend(size() + n));
+    avail_ = std::uninitialized_fill_n(avail_, n, tmp);
+}
 
-        //填充后面的元素
-        while(size() < n)
-            unCheckedAppend(val);
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::resize_default_init(size_type n)
+{
+    if(n <= size())
+    {
+        erase(data_ + n, avail_);
+        return;
     }
+    if(n > capacity())
+        growToN(recommend(n));
+    defaultInit(avail_, data_ + n, std::integral_constant<bool,
+        std::is_trivially_default_constructible<T>::value>());
+    avail_ = data_ + n;
 }
 
-template <typename T, typename Alloc>
-void Vector<T, Alloc>::reserve (size_type n)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::defaultInit(iterator first, iterator last, std::false_type)
+{
+    iterator cur = first;
+    try
+    {
+        for(; cur != last; ++cur)
+            ::new (static_cast<void *>(cur)) T;
+    }
+    catch(...)
+    {
+        while(cur != first)
+            alloc_traits::destroy(alloc(), --cur);
+        throw;
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::resize_uninitialized(size_type n)
+{
+    static_assert(std::is_trivially_default_constructible<T>::value && std::is_trivially_destructible<T>::value,
+                  "resize_uninitialized requires a trivial element type");
+    resize_default_init(n);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+template <typename Op>
+void Vector<T, Alloc, Growth, Stats>::resize_and_overwrite(size_type n, Op op)
+{
+    static_assert(std::is_trivially_default_constructible<T>::value && std::is_trivially_destructible<T>::value,
+                  "resize_and_overwrite requires a trivial element type");
+    if(n > capacity())
+    {
+        if(n > max_size())
+            throw std::length_error("Vector::resize_and_overwrite");
+        growToN(recommend(n));
+    }
+    size_type count = op(data_, n);
+    if(count > n)
+        throw std::length_error("Vector::resize_and_overwrite");
+    avail_ = data_ + count;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::copy_from(const parallel_policy &policy, const Vector &other)
+{
+    if(this == &other)
+        return;
+    if(!std::is_nothrow_copy_constructible<T>::value)
+    {
+        assign(other.begin(), other.end());
+        return;
+    }
+
+    clear(policy);
+    size_type n = other.size();
+    if(n > capacity())
+    {
+        uncreate();
+        size_type cap = n;
+        data_ = avail_ = allocateAtLeast(cap);
+        limit_ = data_ + cap;
+    }
+    iterator dest = data_;
+    const_iterator src = other.data_;
+    parallelChunks(policy, n, sizeof(T), [dest, src](size_t first, size_t last) {
+        std::uninitialized_copy(src + first, src + last, dest + first);
+    });
+    avail_ = data_ + n;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::resize(const parallel_policy &policy, size_type n, value_type val)
+{
+    if(!std::is_nothrow_copy_constructible<T>::value)
+    {
+        resize(n, val);
+        return;
+    }
+    if(n <= size())
+    {
+        parallelDestroy(policy, data_ + n, avail_);
+        avail_ = data_ + n;
+        return;
+    }
+    if(n > capacity())
+        growToN(recommend(n));
+    parallelFill(policy, avail_, n - size(), val);
+    avail_ = data_ + n;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::clear(const parallel_policy &policy)
+{
+    parallelDestroy(policy, data_, avail_);
+    avail_ = data_;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::parallelFill(const parallel_policy &policy, iterator dest,
+                                                  size_type n, const value_type &val)
+{
+    parallelChunks(policy, n, sizeof(T), [dest, &val](size_t first, size_t last) {
+        std::uninitialized_fill(dest + first, dest + last, val);
+    });
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::parallelDestroy(const parallel_policy &policy, iterator first, iterator last)
+{
+    if(std::is_trivially_destructible<T>::value)
+        return;
+    Alloc *a = &alloc();
+    parallelChunks(policy, last - first, sizeof(T), [first, a](size_t begin, size_t end) {
+        for(size_t ix = begin; ix != end; ++ix)
+            alloc_traits::destroy(*a, first + ix);
+    });
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::reserve (size_type n)
 {
     size_type current_capacity = capacity();
     if(n > current_capacity)
     {
+        if(n > max_size())
+            throw std::length_error("Vector::reserve");
         growToN(n);
     }
 }
 
-template <typename T, typename Alloc>
-bool operator==(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::shrink_to_fit()
 {
-    return lhs.size() == rhs.size() && 
-        std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    if(avail_ != limit_)
+        shrinkTo(size());
 }
 
-template <typename T, typename Alloc>
-bool operator!=(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::shrinkTo(size_type n)
 {
-    return !(lhs == rhs);
+    if(n == 0)
+    {
+        deallocate(data_, limit_ - data_);
+        data_ = avail_ = limit_ = NULL;
+        return;
+    }
+    //growToN对任何不小于size()的容量都成立
+    growToN(n, std::integral_constant<bool,
+        is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value>());
 }
 
-template <typename T, typename Alloc>
-bool operator<(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Vector<T, Alloc, Growth, Stats>::autoTrim(std::true_type)
 {
-    typedef typename Vector<T, Alloc>::size_type size_type;
-    size_type size1 = lhs.size();
-    size_type size2 = rhs.size();
-    size_type min_size = (size1 < size2) ? size1 : size2;
-    size_type ix = 0;
-    for(; ix != min_size; ++ix)
+    size_type n = Growth::shrink(capacity(), size(), sizeof(T));
+    if(n >= capacity())
+        return;
+    try
+    {
+        shrinkTo(std::max(n, size()));
+    }
+    catch(...)
     {
-        if(lhs[ix] < rhs[ix])
-            return true;
-        else if(lhs[ix] > rhs[ix])
-            return false;
+        //收缩只是为了省内存，失败时元素和容量都不变
     }
-    if(ix != size2) //rhs较长
-        return true;
-    return false;
 }
 
-template <typename T, typename Alloc>
-bool operator<=(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator==(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs)
+{
+    return lhs.size() == rhs.size() && 
+        vector_compare::equal(lhs.begin(), rhs.begin(), lhs.size());
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator!=(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator<(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs)
+{
+    return compare(lhs, rhs) < 0;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator<=(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs)
+{
+    return compare(lhs, rhs) <= 0;        //lhs <= rhs
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator>(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs)
 {
-    return !(rhs < lhs);        //lhs <= rhs
+    return compare(lhs, rhs) > 0; //lhs > rhs
 }
 
-template <typename T, typename Alloc>
-bool operator>(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator>=(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs)
 {
-    return rhs < lhs; //lhs > rhs
+    return compare(lhs, rhs) >= 0;
 }
 
-template <typename T, typename Alloc>
-bool operator>=(const Vector<T, Alloc> &lhs, const Vector<T, Alloc> &rhs)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+int compare(const Vector<T, Alloc, Growth, Stats> &lhs, const Vector<T, Alloc, Growth, Stats> &rhs)
 {
-    return !(lhs < rhs);
+    //只扫描一遍，<=和>=不必再比较第二次
+    return vector_compare::compare(lhs.begin(), lhs.size(), rhs.begin(), rhs.size());
 }
 
 #endif  /* VECTOR_HPP */
\ No newline at end of file
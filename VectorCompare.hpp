@@ -0,0 +1,183 @@
+#ifndef VECTORCOMPARE_HPP
+#define VECTORCOMPARE_HPP
+
+#include <type_traits>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VECTOR_COMPARE_X86 1
+#endif
+
+//Vector比较运算符使用的内核，按元素类型选择实现：
+//  单字节无符号类型      memcmp直接给出字典序
+//  其他整数              memcmp判断相等，比较时先用SIMD找到第一个不同的字节
+//  浮点数                同上，但+0/-0、NaN按字节不同却不可区分，需要逐个确认
+//  其余类型              逐个元素比较
+namespace vector_compare
+{
+
+typedef size_t (*MismatchFn)(const unsigned char *, const unsigned char *, size_t);
+
+//返回第一个不同字节的下标，全部相同时返回n
+inline size_t mismatchScalar(const unsigned char *a, const unsigned char *b, size_t n)
+{
+    size_t ix = 0;
+    for(; ix + 8 <= n; ix += 8)
+    {
+        uint64_t x, y;
+        memcpy(&x, a + ix, 8);
+        memcpy(&y, b + ix, 8);
+        if(x != y) //小端机器上最低的不同位就是第一个不同的字节
+            return ix + __builtin_ctzll(x ^ y) / 8;
+    }
+    for(; ix != n; ++ix)
+        if(a[ix] != b[ix])
+            return ix;
+    return n;
+}
+
+#ifdef VECTOR_COMPARE_X86
+inline size_t mismatchSse2(const unsigned char *a, const unsigned char *b, size_t n)
+{
+    size_t ix = 0;
+    for(; ix + 16 <= n; ix += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + ix));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + ix));
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xFFFFu;
+        if(mask)
+            return ix + __builtin_ctz(mask);
+    }
+    return ix + mismatchScalar(a + ix, b + ix, n - ix);
+}
+
+__attribute__((target("avx2")))
+inline size_t mismatchAvx2(const unsigned char *a, const unsigned char *b, size_t n)
+{
+    size_t ix = 0;
+    for(; ix + 32 <= n; ix += 32)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + ix));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + ix));
+        unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if(mask)
+            return ix + __builtin_ctz(mask);
+    }
+    return ix + mismatchSse2(a + ix, b + ix, n - ix);
+}
+#endif
+
+//运行时根据CPU选择实现，只判断一次
+inline MismatchFn selectMismatch()
+{
+#ifdef VECTOR_COMPARE_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        return mismatchAvx2;
+    return mismatchSse2;
+#else
+    return mismatchScalar;
+#endif
+}
+
+inline size_t mismatchBytes(const void *a, const void *b, size_t n)
+{
+    static const MismatchFn fn = selectMismatch();
+    return fn(static_cast<const unsigned char *>(a), static_cast<const unsigned char *>(b), n);
+}
+
+//按字节比较就是字典序
+template <typename T>
+struct is_byte_ordered : std::integral_constant<bool,
+    sizeof(T) == 1 && std::is_integral<T>::value && std::is_unsigned<T>::value> { };
+
+//按字节相等等价于值相等
+template <typename T>
+struct is_byte_equal : std::integral_constant<bool, std::is_integral<T>::value> { };
+
+struct generic_tag { };
+struct byte_ordered_tag { };
+struct mismatch_tag { };
+
+template <typename T>
+struct compare_category
+{
+    typedef typename std::conditional<is_byte_ordered<T>::value, byte_ordered_tag,
+            typename std::conditional<std::is_arithmetic<T>::value, mismatch_tag,
+            generic_tag>::type>::type type;
+};
+
+template <typename T>
+bool equal(const T *a, const T *b, size_t n, std::true_type)
+{   return n == 0 || memcmp(a, b, n * sizeof(T)) == 0;    }
+
+template <typename T>
+bool equal(const T *a, const T *b, size_t n, std::false_type)
+{
+    for(size_t ix = 0; ix != n; ++ix)
+        if(!(a[ix] == b[ix]))
+            return false;
+    return true;
+}
+
+//[a, a + n)与[b, b + n)是否相等
+template <typename T>
+bool equal(const T *a, const T *b, size_t n)
+{   return equal(a, b, n, typename is_byte_equal<T>::type());   }
+
+template <typename T>
+int compareN(const T *a, const T *b, size_t n, generic_tag)
+{
+    for(size_t ix = 0; ix != n; ++ix)
+    {
+        if(a[ix] < b[ix])
+            return -1;
+        if(b[ix] < a[ix])
+            return 1;
+    }
+    return 0;
+}
+
+template <typename T>
+int compareN(const T *a, const T *b, size_t n, byte_ordered_tag)
+{
+    if(n == 0)
+        return 0;
+    int result = memcmp(a, b, n);
+    return (result > 0) - (result < 0);
+}
+
+template <typename T>
+int compareN(const T *a, const T *b, size_t n, mismatch_tag)
+{
+    size_t ix = 0;
+    while(ix != n)
+    {
+        ix += mismatchBytes(a + ix, b + ix, (n - ix) * sizeof(T)) / sizeof(T);
+        if(ix == n)
+            break;
+        if(a[ix] < b[ix])
+            return -1;
+        if(b[ix] < a[ix])
+            return 1;
+        ++ix; //+0和-0、NaN：字节不同，但不分大小
+    }
+    return 0;
+}
+
+//字典序三路比较，返回-1、0或1
+template <typename T>
+int compare(const T *a, size_t na, const T *b, size_t nb)
+{
+    int result = compareN(a, b, na < nb ? na : nb, typename compare_category<T>::type());
+    if(result != 0)
+        return result;
+    return (na > nb) - (na < nb);
+}
+
+}
+
+#endif  /* VECTORCOMPARE_HPP */
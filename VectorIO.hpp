@@ -0,0 +1,316 @@
+#ifndef VECTORIO_HPP
+#define VECTORIO_HPP
+
+#include "Vector.hpp"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <stdexcept>
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+//Vector的二进制格式：32字节的文件头后面紧跟[data_, avail_)
+//嵌套的Vector<Vector<T> >在文件头后面先写每个内层的长度，再依次写内层的数据
+struct VectorFileHeader
+{
+    char magic[4]; //"VEC1"
+    uint8_t version;
+    uint8_t nested; //是否是Vector<Vector<T> >
+    uint16_t reserved;
+    uint32_t byte_order; //按本机字节序写入kByteOrder
+    uint32_t elem_size;
+    uint64_t count; //元素数量，嵌套时是外层的数量
+    uint64_t checksum; //所有数据字节的校验和
+
+    static const uint32_t kByteOrder = 0x01020304;
+};
+
+namespace vector_io
+{
+
+//四路并行的FNV-1a，每次处理8个字节，不至于成为瓶颈
+class Checksum
+{
+public:
+    Checksum()
+    {
+        for(int ix = 0; ix != 4; ++ix)
+            lane_[ix] = 0xcbf29ce484222325ULL + ix;
+    }
+
+    void update(const void *data, size_t n)
+    {
+        const unsigned char *p = static_cast<const unsigned char *>(data);
+        size_t ix = 0;
+        for(; ix + 32 <= n; ix += 32)
+        {
+            for(int lane = 0; lane != 4; ++lane)
+            {
+                uint64_t w;
+                memcpy(&w, p + ix + lane * 8, 8);
+                lane_[lane] = (lane_[lane] ^ w) * kPrime;
+            }
+        }
+        for(; ix != n; ++ix)
+            lane_[0] = (lane_[0] ^ p[ix]) * kPrime;
+    }
+
+    uint64_t value() const
+    {
+        uint64_t h = lane_[0];
+        for(int ix = 1; ix != 4; ++ix)
+            h = (h ^ lane_[ix]) * kPrime;
+        return h;
+    }
+
+private:
+    static const uint64_t kPrime = 0x100000001b3ULL;
+    uint64_t lane_[4];
+};
+
+inline void fail(const std::string &what)
+{   throw std::runtime_error("VectorIO: " + what + ": " + strerror(errno));   }
+
+inline VectorFileHeader makeHeader(size_t elem_size, size_t count, bool nested, uint64_t checksum)
+{
+    VectorFileHeader h = VectorFileHeader();
+    memcpy(h.magic, "VEC1", 4);
+    h.version = 1;
+    h.nested = nested;
+    h.reserved = 0;
+    h.byte_order = VectorFileHeader::kByteOrder;
+    h.elem_size = static_cast<uint32_t>(elem_size);
+    h.count = count;
+    h.checksum = checksum;
+    return h;
+}
+
+inline void checkHeader(const VectorFileHeader &h, size_t elem_size, bool nested)
+{
+    if(memcmp(h.magic, "VEC1", 4) != 0 || h.version != 1)
+        throw std::runtime_error("VectorIO: bad magic");
+    if(h.byte_order != VectorFileHeader::kByteOrder)
+        throw std::runtime_error("VectorIO: byte order mismatch");
+    if(h.elem_size != elem_size || h.nested != nested)
+        throw std::runtime_error("VectorIO: element type mismatch");
+}
+
+inline void checkSum(const VectorFileHeader &h, const Checksum &sum)
+{
+    if(h.checksum != sum.value())
+        throw std::runtime_error("VectorIO: checksum mismatch");
+}
+
+//writev/readv直到全部完成，处理部分写入、EINTR和IOV_MAX
+//长度为0的iovec先跳过：只剩它们时readv返回0，会被当成文件结束
+template <typename Op>
+void transferAll(int fd, struct iovec *iov, size_t cnt, Op op, const char *what)
+{
+    for(;;)
+    {
+        while(cnt != 0 && iov->iov_len == 0)
+        {
+            ++iov;
+            --cnt;
+        }
+        if(cnt == 0)
+            return;
+        int batch = static_cast<int>(cnt < IOV_MAX ? cnt : IOV_MAX);
+        ssize_t n = op(fd, iov, batch);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            fail(what);
+        }
+        if(n == 0)
+            throw std::runtime_error(std::string("VectorIO: ") + what + ": unexpected end of file");
+        size_t done = static_cast<size_t>(n);
+        while(cnt != 0 && done >= iov->iov_len)
+        {
+            done -= iov->iov_len;
+            ++iov;
+            --cnt;
+        }
+        if(cnt != 0)
+        {
+            iov->iov_base = static_cast<char *>(iov->iov_base) + done;
+            iov->iov_len -= done;
+        }
+    }
+}
+
+inline void writeAll(int fd, struct iovec *iov, size_t cnt)
+{   transferAll(fd, iov, cnt, ::writev, "writev");  }
+inline void readAll(int fd, struct iovec *iov, size_t cnt)
+{   transferAll(fd, iov, cnt, ::readv, "readv");    }
+
+inline struct iovec makeIovec(const void *p, size_t n)
+{
+    struct iovec v;
+    v.iov_base = const_cast<void *>(p);
+    v.iov_len = n;
+    return v;
+}
+
+}
+
+//只对可平凡拷贝的元素提供整块读写
+template <typename T>
+struct enable_if_raw_io : std::enable_if<std::is_trivially_copyable<T>::value> { };
+
+//把vec写到fd，文件头和数据在同一次writev中
+template <typename T, typename A, typename G, typename S>
+typename enable_if_raw_io<T>::type write_to(int fd, const Vector<T, A, G, S> &vec)
+{
+    vector_io::Checksum sum;
+    sum.update(vec.begin(), vec.size() * sizeof(T));
+    VectorFileHeader h = vector_io::makeHeader(sizeof(T), vec.size(), false, sum.value());
+    struct iovec iov[2] = {
+        vector_io::makeIovec(&h, sizeof(h)),
+        vector_io::makeIovec(vec.begin(), vec.size() * sizeof(T))
+    };
+    vector_io::writeAll(fd, iov, 2);
+}
+
+template <typename T, typename A, typename G, typename S>
+typename enable_if_raw_io<T>::type write_to(std::ostream &os, const Vector<T, A, G, S> &vec)
+{
+    vector_io::Checksum sum;
+    sum.update(vec.begin(), vec.size() * sizeof(T));
+    VectorFileHeader h = vector_io::makeHeader(sizeof(T), vec.size(), false, sum.value());
+    os.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    os.write(reinterpret_cast<const char *>(vec.begin()), vec.size() * sizeof(T));
+    if(!os)
+        throw std::runtime_error("VectorIO: write failed");
+}
+
+//从fd读入vec，原有的元素被替换，校验失败时抛出runtime_error
+//先读到临时的Vector，全部成功后才交换，失败时vec不变
+template <typename T, typename A, typename G, typename S>
+typename enable_if_raw_io<T>::type read_from(int fd, Vector<T, A, G, S> &vec)
+{
+    VectorFileHeader h = VectorFileHeader();
+    struct iovec head = vector_io::makeIovec(&h, sizeof(h));
+    vector_io::readAll(fd, &head, 1);
+    vector_io::checkHeader(h, sizeof(T), false);
+
+    Vector<T, A, G, S> tmp(vec.get_allocator());
+    tmp.resize_default_init(h.count); //马上被文件内容覆盖，不需要初始化
+    struct iovec body = vector_io::makeIovec(tmp.begin(), h.count * sizeof(T));
+    vector_io::readAll(fd, &body, 1);
+
+    vector_io::Checksum sum;
+    sum.update(tmp.begin(), tmp.size() * sizeof(T));
+    vector_io::checkSum(h, sum);
+    vec.swap(tmp);
+}
+
+template <typename T, typename A, typename G, typename S>
+typename enable_if_raw_io<T>::type read_from(std::istream &is, Vector<T, A, G, S> &vec)
+{
+    VectorFileHeader h = VectorFileHeader();
+    if(!is.read(reinterpret_cast<char *>(&h), sizeof(h)))
+        throw std::runtime_error("VectorIO: read failed");
+    vector_io::checkHeader(h, sizeof(T), false);
+
+    Vector<T, A, G, S> tmp(vec.get_allocator());
+    tmp.resize_default_init(h.count);
+    if(!is.read(reinterpret_cast<char *>(tmp.begin()), h.count * sizeof(T)))
+        throw std::runtime_error("VectorIO: read failed");
+
+    vector_io::Checksum sum;
+    sum.update(tmp.begin(), tmp.size() * sizeof(T));
+    vector_io::checkSum(h, sum);
+    vec.swap(tmp);
+}
+
+//Vector<Vector<T> >：文件头、长度数组和所有内层数据用writev一起写出
+template <typename T, typename A, typename G, typename S, typename A2, typename G2, typename S2>
+typename enable_if_raw_io<T>::type write_to(int fd, const Vector<Vector<T, A, G, S>, A2, G2, S2> &vec)
+{
+    Vector<uint64_t> lengths(vec.size());
+    Vector<struct iovec> iov;
+    iov.reserve(vec.size() + 2);
+    vector_io::Checksum sum;
+
+    iov.push_back(vector_io::makeIovec(NULL, 0)); //文件头最后填写
+    iov.push_back(vector_io::makeIovec(lengths.begin(), lengths.size() * sizeof(uint64_t)));
+    for(size_t ix = 0; ix != vec.size(); ++ix)
+    {
+        lengths[ix] = vec[ix].size();
+        sum.update(vec[ix].begin(), vec[ix].size() * sizeof(T));
+        if(!vec[ix].empty())
+            iov.push_back(vector_io::makeIovec(vec[ix].begin(), vec[ix].size() * sizeof(T)));
+    }
+
+    VectorFileHeader h = vector_io::makeHeader(sizeof(T), vec.size(), true, sum.value());
+    iov[0] = vector_io::makeIovec(&h, sizeof(h));
+    vector_io::writeAll(fd, iov.begin(), iov.size());
+}
+
+template <typename T, typename A, typename G, typename S, typename A2, typename G2, typename S2>
+typename enable_if_raw_io<T>::type read_from(int fd, Vector<Vector<T, A, G, S>, A2, G2, S2> &vec)
+{
+    VectorFileHeader h = VectorFileHeader();
+    struct iovec head = vector_io::makeIovec(&h, sizeof(h));
+    vector_io::readAll(fd, &head, 1);
+    vector_io::checkHeader(h, sizeof(T), true);
+
+    Vector<uint64_t> lengths;
+    lengths.resize_uninitialized(h.count);
+    struct iovec len_iov = vector_io::makeIovec(lengths.begin(), lengths.size() * sizeof(uint64_t));
+    vector_io::readAll(fd, &len_iov, 1);
+
+    Vector<Vector<T, A, G, S>, A2, G2, S2> tmp(vec.get_allocator());
+    tmp.resize(h.count);
+    Vector<struct iovec> iov;
+    iov.reserve(h.count);
+    for(size_t ix = 0; ix != tmp.size(); ++ix)
+    {
+        tmp[ix].resize_default_init(lengths[ix]);
+        if(lengths[ix] != 0)
+            iov.push_back(vector_io::makeIovec(tmp[ix].begin(), lengths[ix] * sizeof(T)));
+    }
+    vector_io::readAll(fd, iov.begin(), iov.size());
+
+    vector_io::Checksum sum;
+    for(size_t ix = 0; ix != tmp.size(); ++ix)
+        sum.update(tmp[ix].begin(), tmp[ix].size() * sizeof(T));
+    vector_io::checkSum(h, sum);
+    vec.swap(tmp);
+}
+
+//指向已有缓冲区的只读视图，不拷贝数据
+template <typename T>
+using SerializedView = VectorView<const T>;
+
+//把buf中write_to写出的内容当作T数组使用，buf需要按T对齐且比视图活得久
+//verify为true时检查校验和，需要扫描一遍数据
+template <typename T>
+SerializedView<T> view_from(const void *buf, size_t len, bool verify = false)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "view_from requires trivially copyable T");
+    VectorFileHeader h = VectorFileHeader();
+    if(len < sizeof(h))
+        throw std::runtime_error("VectorIO: buffer too small");
+    memcpy(&h, buf, sizeof(h));
+    vector_io::checkHeader(h, sizeof(T), false);
+    if(h.count > (len - sizeof(h)) / sizeof(T))
+        throw std::runtime_error("VectorIO: buffer too small");
+
+    SerializedView<T> view(reinterpret_cast<const T *>(static_cast<const char *>(buf) + sizeof(h)),
+                           static_cast<size_t>(h.count));
+    if(verify)
+    {
+        vector_io::Checksum sum;
+        sum.update(view.data(), view.size() * sizeof(T));
+        vector_io::checkSum(h, sum);
+    }
+    return view;
+}
+
+#endif  /* VECTORIO_HPP */
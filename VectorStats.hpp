@@ -0,0 +1,208 @@
+#ifndef VECTORSTATS_HPP
+#define VECTORSTATS_HPP
+
+#include "Vector.hpp"
+#include <atomic>
+#include <ostream>
+#include <iomanip>
+#include <stdint.h>
+
+//按调用点统计Vector的内存行为：
+//  VECTOR_STATS_TAG(PendingQueue);
+//  Vector<Job, std::allocator<Job>, GrowDouble, VectorStats<PendingQueue> > queue;
+//同一个Tag的所有Vector共用一组计数器，计数器在第一次使用时登记到VectorStatsRegistry
+//计数使用relaxed原子操作，可以在多个线程中使用
+
+#define VECTOR_STATS_STRINGIFY2(x) #x
+#define VECTOR_STATS_STRINGIFY(x) VECTOR_STATS_STRINGIFY2(x)
+
+//定义一个调用点标签，记录名字和所在的文件、行号
+#define VECTOR_STATS_TAG(Name) \
+    struct Name \
+    { \
+        static const char *name() { return #Name; } \
+        static const char *location() { return __FILE__ ":" VECTOR_STATS_STRINGIFY(__LINE__); } \
+    }
+
+//某一时刻的计数
+struct VectorStatsSnapshot
+{
+    const char *name;
+    const char *location;
+    uint64_t allocations;
+    uint64_t deallocations;
+    uint64_t bytes_allocated;
+    uint64_t bytes_freed;
+    uint64_t regrowths; //容量不够引起的重新分配
+    uint64_t elements_moved; //搬迁时移动或按字节搬走的元素
+    uint64_t elements_copied; //移动构造可能抛异常，只能拷贝的元素
+    uint64_t peak_capacity; //单个Vector达到过的最大容量
+};
+
+//一个调用点的计数器
+class VectorSiteStats
+{
+public:
+    VectorSiteStats(const char *name, const char *location);
+
+    VectorSiteStats(const VectorSiteStats &) = delete;
+    VectorSiteStats &operator=(const VectorSiteStats &) = delete;
+
+    void allocated(uint64_t bytes, uint64_t capacity)
+    {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+        uint64_t peak = peak_capacity_.load(std::memory_order_relaxed);
+        while(capacity > peak
+              && !peak_capacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed))
+            ;
+    }
+    void deallocated(uint64_t bytes)
+    {
+        deallocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_freed_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    void regrown()
+    {   regrowths_.fetch_add(1, std::memory_order_relaxed);  }
+    void relocated(uint64_t n, bool copied)
+    {   (copied ? elements_copied_ : elements_moved_).fetch_add(n, std::memory_order_relaxed);   }
+
+    VectorStatsSnapshot snapshot() const;
+    void reset();
+
+    VectorSiteStats *next() const { return next_; }
+
+private:
+    friend class VectorStatsRegistry;
+
+    const char *name_;
+    const char *location_;
+    std::atomic<uint64_t> allocations_;
+    std::atomic<uint64_t> deallocations_;
+    std::atomic<uint64_t> bytes_allocated_;
+    std::atomic<uint64_t> bytes_freed_;
+    std::atomic<uint64_t> regrowths_;
+    std::atomic<uint64_t> elements_moved_;
+    std::atomic<uint64_t> elements_copied_;
+    std::atomic<uint64_t> peak_capacity_;
+    VectorSiteStats *next_; //登记链表中的下一个
+};
+
+//进程内所有调用点的登记表，调用点只增不减
+class VectorStatsRegistry
+{
+public:
+    static VectorStatsRegistry &instance()
+    {
+        static VectorStatsRegistry registry;
+        return registry;
+    }
+
+    void add(VectorSiteStats *site)
+    {
+        site->next_ = head_.load(std::memory_order_relaxed);
+        while(!head_.compare_exchange_weak(site->next_, site,
+                                           std::memory_order_release, std::memory_order_relaxed))
+            ;
+    }
+
+    Vector<VectorStatsSnapshot> snapshot() const
+    {
+        Vector<VectorStatsSnapshot> result;
+        for(VectorSiteStats *site = head_.load(std::memory_order_acquire); site; site = site->next())
+            result.push_back(site->snapshot());
+        return result;
+    }
+
+    //按key从大到小输出每个调用点的计数
+    void report(std::ostream &os,
+                uint64_t VectorStatsSnapshot::*key = &VectorStatsSnapshot::bytes_allocated) const;
+
+    void reset()
+    {
+        for(VectorSiteStats *site = head_.load(std::memory_order_acquire); site; site = site->next())
+            site->reset();
+    }
+
+private:
+    VectorStatsRegistry() :head_(NULL) { }
+
+    std::atomic<VectorSiteStats *> head_;
+};
+
+inline VectorSiteStats::VectorSiteStats(const char *name, const char *location)
+    :name_(name), location_(location), allocations_(0), deallocations_(0),
+     bytes_allocated_(0), bytes_freed_(0), regrowths_(0), elements_moved_(0),
+     elements_copied_(0), peak_capacity_(0), next_(NULL)
+{
+    VectorStatsRegistry::instance().add(this);
+}
+
+inline VectorStatsSnapshot VectorSiteStats::snapshot() const
+{
+    VectorStatsSnapshot s;
+    s.name = name_;
+    s.location = location_;
+    s.allocations = allocations_.load(std::memory_order_relaxed);
+    s.deallocations = deallocations_.load(std::memory_order_relaxed);
+    s.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+    s.bytes_freed = bytes_freed_.load(std::memory_order_relaxed);
+    s.regrowths = regrowths_.load(std::memory_order_relaxed);
+    s.elements_moved = elements_moved_.load(std::memory_order_relaxed);
+    s.elements_copied = elements_copied_.load(std::memory_order_relaxed);
+    s.peak_capacity = peak_capacity_.load(std::memory_order_relaxed);
+    return s;
+}
+
+inline void VectorSiteStats::reset()
+{
+    allocations_ = 0;
+    deallocations_ = 0;
+    bytes_allocated_ = 0;
+    bytes_freed_ = 0;
+    regrowths_ = 0;
+    elements_moved_ = 0;
+    elements_copied_ = 0;
+    peak_capacity_ = 0;
+}
+
+inline void VectorStatsRegistry::report(std::ostream &os, uint64_t VectorStatsSnapshot::*key) const
+{
+    Vector<VectorStatsSnapshot> sites = snapshot();
+    std::stable_sort(sites.begin(), sites.end(),
+        [key](const VectorStatsSnapshot &a, const VectorStatsSnapshot &b) { return a.*key > b.*key; });
+
+    os << std::left << std::setw(24) << "site" << std::right
+       << std::setw(10) << "allocs" << std::setw(10) << "frees"
+       << std::setw(14) << "bytes" << std::setw(14) << "live bytes"
+       << std::setw(10) << "regrows" << std::setw(12) << "moved"
+       << std::setw(12) << "copied" << std::setw(12) << "peak cap" << "  location\n";
+    for(Vector<VectorStatsSnapshot>::const_iterator it = sites.begin(); it != sites.end(); ++it)
+    {
+        os << std::left << std::setw(24) << it->name << std::right
+           << std::setw(10) << it->allocations << std::setw(10) << it->deallocations
+           << std::setw(14) << it->bytes_allocated
+           << std::setw(14) << it->bytes_allocated - it->bytes_freed
+           << std::setw(10) << it->regrowths << std::setw(12) << it->elements_moved
+           << std::setw(12) << it->elements_copied << std::setw(12) << it->peak_capacity
+           << "  " << it->location << "\n";
+    }
+}
+
+//把计数记到Tag对应的调用点上，Vector的大小不变
+template <typename Tag>
+struct VectorStats
+{
+    static VectorSiteStats &site()
+    {
+        static VectorSiteStats stats(Tag::name(), Tag::location());
+        return stats;
+    }
+
+    static void onAllocate(size_t bytes, size_t capacity) { site().allocated(bytes, capacity); }
+    static void onDeallocate(size_t bytes) { site().deallocated(bytes); }
+    static void onRegrow(size_t /*old_capacity*/, size_t /*new_capacity*/) { site().regrown(); }
+    static void onRelocate(size_t n, bool copied) { site().relocated(n, copied); }
+};
+
+#endif  /* VECTORSTATS_HPP */
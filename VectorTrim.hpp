@@ -0,0 +1,157 @@
+#ifndef VECTORTRIM_HPP
+#define VECTORTRIM_HPP
+
+#include "Vector.hpp"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+//内存紧张时统一收缩长期存在的容器：
+//  Vector<Session> sessions;
+//  ScopedVectorTrim trim("sessions", sessions); //作用域结束时自动注销
+//  ...
+//  size_t freed = VectorTrimRegistry::instance().trim_all(); //收到内存压力通知时
+//trim_all在调用它的线程中依次收缩每个容器，容器同时被其他线程使用时，
+//应该注册自己加锁的回调；不能在信号处理函数中调用
+//回调执行时不持有注册表的锁，回调中可以注册、注销其他容器；
+//ScopedVectorTrim析构时会等待自己的回调执行完，所以不能在回调中析构它自己，
+//也不能在持有回调需要的锁时析构它
+class ScopedVectorTrim;
+
+namespace vector_trim
+{
+
+//注册表和ScopedVectorTrim共同持有，trim_all在锁外执行回调时它不会被释放
+struct Entry
+{
+    Entry(const char *n, std::function<size_t()> fn) :name(n), trim(std::move(fn)), alive(true) { }
+
+    const char *name;
+    std::function<size_t()> trim;
+    std::mutex mutex; //回调执行期间持有，析构ScopedVectorTrim时等待
+    bool alive;
+};
+
+typedef std::shared_ptr<Entry> EntryPtr;
+
+}
+
+//进程内所有注册的容器
+class VectorTrimRegistry
+{
+public:
+    static VectorTrimRegistry &instance()
+    {
+        static VectorTrimRegistry registry;
+        return registry;
+    }
+
+    //收缩所有注册的容器，返回释放的字节数；log不为NULL时逐个输出名字和释放的字节数
+    //先在锁内拷贝登记的列表，回调在锁外执行
+    size_t trim_all(std::ostream *log = NULL);
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    friend class ScopedVectorTrim;
+
+    VectorTrimRegistry() { }
+
+    void add(const vector_trim::EntryPtr &entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_back(entry);
+    }
+    void remove(const vector_trim::EntryPtr &entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(Vector<vector_trim::EntryPtr>::iterator it = entries_.begin(); it != entries_.end(); ++it)
+            if(*it == entry)
+            {
+                entries_.swap_erase(it);
+                return;
+            }
+    }
+
+    mutable std::mutex mutex_;
+    Vector<vector_trim::EntryPtr> entries_;
+};
+
+//在生命期内把一个容器登记到VectorTrimRegistry
+class ScopedVectorTrim
+{
+public:
+    typedef std::function<size_t()> TrimFn; //收缩并返回释放的字节数
+
+    //收缩时调用vec.shrink_to_fit()，vec必须比本对象活得久
+    //只接受有shrink_to_fit()的容器，其他可调用对象走TrimFn的重载，按值保存
+    template <typename V, typename = decltype(std::declval<V &>().shrink_to_fit())>
+    ScopedVectorTrim(const char *name, V &vec)
+        :entry_(std::make_shared<vector_trim::Entry>(name, shrinkFn(vec)))
+    {   VectorTrimRegistry::instance().add(entry_);  }
+    ScopedVectorTrim(const char *name, TrimFn fn)
+        :entry_(std::make_shared<vector_trim::Entry>(name, std::move(fn)))
+    {   VectorTrimRegistry::instance().add(entry_);  }
+    ~ScopedVectorTrim()
+    {
+        VectorTrimRegistry::instance().remove(entry_);
+        //trim_all可能已经拷贝了列表，等正在执行的回调结束，之后不再调用
+        std::lock_guard<std::mutex> lock(entry_->mutex);
+        entry_->alive = false;
+    }
+
+    ScopedVectorTrim(const ScopedVectorTrim &) = delete;
+    ScopedVectorTrim &operator=(const ScopedVectorTrim &) = delete;
+
+    const char *name() const { return entry_->name; }
+    size_t trim()
+    {
+        std::lock_guard<std::mutex> lock(entry_->mutex);
+        return entry_->trim();
+    }
+
+private:
+    template <typename V>
+    static TrimFn shrinkFn(V &vec)
+    {
+        return [&vec]() -> size_t {
+            size_t before = vec.capacity();
+            vec.shrink_to_fit();
+            return (before - vec.capacity()) * sizeof(typename V::value_type);
+        };
+    }
+
+    vector_trim::EntryPtr entry_;
+};
+
+inline size_t VectorTrimRegistry::trim_all(std::ostream *log)
+{
+    Vector<vector_trim::EntryPtr> entries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries = entries_;
+    }
+    size_t total = 0;
+    for(Vector<vector_trim::EntryPtr>::iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        size_t freed;
+        {
+            std::lock_guard<std::mutex> lock((*it)->mutex);
+            if(!(*it)->alive) //拷贝列表之后被注销了
+                continue;
+            freed = (*it)->trim();
+        }
+        total += freed;
+        if(log)
+            *log << (*it)->name << ": " << freed << " bytes\n";
+    }
+    if(log)
+        *log << "total: " << total << " bytes\n";
+    return total;
+}
+
+#endif  /* VECTORTRIM_HPP */
@@ -0,0 +1,85 @@
+#ifndef VECTORVIEW_HPP
+#define VECTORVIEW_HPP
+
+#include <type_traits>
+#include <stdexcept>
+#include <stddef.h>
+#include "VectorCompare.hpp"
+
+//指向一段连续元素的视图，不拥有也不拷贝元素，被指向的容器必须比视图活得久
+//VectorView<T>可以修改元素，VectorView<const T>只读
+//可以从Vector（以及begin()返回指针的容器）隐式构造，比较运算与Vector相同
+template <typename T>
+class VectorView
+{
+public:
+    typedef typename std::remove_const<T>::type value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+    VectorView() :data_(NULL), size_(0) { }
+    VectorView(pointer p, size_type n) :data_(p), size_(n) { }
+    VectorView(pointer first, pointer last) :data_(first), size_(last - first) { }
+
+    //Vector<T>& -> VectorView<T>，const Vector<T>& -> VectorView<const T>
+    template <typename C, typename = typename std::enable_if<
+        std::is_convertible<decltype(std::declval<C &>().begin()), pointer>::value>::type>
+    VectorView(C &c) :data_(c.begin()), size_(c.size()) { }
+
+    iterator begin() const { return data_; }
+    iterator end() const { return data_ + size_; }
+    pointer data() const { return data_; }
+
+    reference operator[] (size_type n) const { return data_[n]; }
+    reference front() const { return data_[0]; }
+    reference back() const { return data_[size_ - 1]; }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+
+    //从pos开始最多len个元素，pos超过size()时抛出out_of_range
+    VectorView slice(size_type pos, size_type len = npos) const
+    {
+        if(pos > size_)
+            throw std::out_of_range("VectorView::slice");
+        return VectorView(data_ + pos, len < size_ - pos ? len : size_ - pos);
+    }
+
+    //比较的两侧可以一个是Vector，另一个是视图
+    friend bool operator==(VectorView lhs, VectorView rhs)
+    {
+        return lhs.size_ == rhs.size_ && vector_compare::equal(
+            static_cast<const value_type *>(lhs.data_), static_cast<const value_type *>(rhs.data_), lhs.size_);
+    }
+    friend bool operator!=(VectorView lhs, VectorView rhs)
+    {   return !(lhs == rhs);   }
+    friend bool operator<(VectorView lhs, VectorView rhs)
+    {   return compare(lhs, rhs) < 0;   }
+    friend bool operator<=(VectorView lhs, VectorView rhs)
+    {   return compare(lhs, rhs) <= 0;  }
+    friend bool operator>(VectorView lhs, VectorView rhs)
+    {   return compare(lhs, rhs) > 0;   }
+    friend bool operator>=(VectorView lhs, VectorView rhs)
+    {   return compare(lhs, rhs) >= 0;  }
+    friend int compare(VectorView lhs, VectorView rhs)
+    {
+        return vector_compare::compare(static_cast<const value_type *>(lhs.data_), lhs.size_,
+                                       static_cast<const value_type *>(rhs.data_), rhs.size_);
+    }
+
+private:
+    pointer data_;
+    size_type size_;
+};
+
+template <typename T>
+const typename VectorView<T>::size_type VectorView<T>::npos;
+
+#endif  /* VECTORVIEW_HPP */
@@ -0,0 +1,1173 @@
+#include "Vector.hpp"
+#include "Allocator.hpp"
+#include "SmallVector.hpp"
+#include "MappedVector.hpp"
+#include "ConcurrentVector.hpp"
+#include "GapVector.hpp"
+#include "SoAVector.hpp"
+#include "CowVector.hpp"
+#include "FlatMap.hpp"
+#include "BitVector.hpp"
+#include "PackedIntVector.hpp"
+#include "RingVector.hpp"
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <new>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <unistd.h>
+#include <sys/resource.h>
+using namespace std;
+
+//用法：bench.exe [过滤子串] [--max=最大元素数] [--min-time=秒]
+//push_back_threads用例的n列是线程数
+//每个用例自动调整迭代次数，直到一次运行超过min-time
+//输出每个元素的耗时、每次迭代的operator new次数和进程的峰值RSS
+
+//统计operator new的调用次数
+//内联之后GCC会把free误报为与operator new不匹配，所以不让它们内联
+static std::atomic<size_t> g_alloc_count(0);
+
+__attribute__((noinline)) void *operator new(size_t n)
+{
+    ++g_alloc_count;
+    void *p = malloc(n ? n : 1);
+    if(p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+//阻止编译器把结果当作无用代码删掉
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline double nowSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//一次运行的状态：用例在while(state.keepRunning())中执行iterations次
+class State
+{
+public:
+    State(size_t n, size_t iterations)
+        :n_(n), iterations_(iterations), left_(iterations), items_(n),
+         started_(false), paused_(false), start_(0), elapsed_(0), allocs_(0) { }
+
+    bool keepRunning()
+    {
+        if(!started_)
+        {
+            started_ = true;
+            resumeTiming();
+        }
+        if(left_ != 0)
+        {
+            --left_;
+            return true;
+        }
+        pauseTiming();
+        return false;
+    }
+
+    //准备数据的代码不计入时间和分配次数
+    void pauseTiming()
+    {
+        if(paused_)
+            return;
+        elapsed_ += nowSeconds() - start_;
+        allocs_ += g_alloc_count - alloc_start_;
+        paused_ = true;
+    }
+    void resumeTiming()
+    {
+        paused_ = false;
+        alloc_start_ = g_alloc_count;
+        start_ = nowSeconds();
+    }
+
+    size_t range() const { return n_; }
+    size_t iterations() const { return iterations_; }
+    //每次迭代处理的元素数，默认是range()
+    void setItemsPerIteration(size_t items) { items_ = items; }
+    size_t items() const { return items_; }
+    double elapsed() const { return elapsed_; }
+    size_t allocs() const { return allocs_; }
+
+private:
+    size_t n_;
+    size_t iterations_;
+    size_t left_;
+    size_t items_;
+    bool started_;
+    bool paused_;
+    double start_;
+    double elapsed_;
+    size_t alloc_start_;
+    size_t allocs_;
+};
+
+typedef void (*BenchFn)(State &);
+
+struct Benchmark
+{
+    string name;
+    BenchFn fn;
+    size_t n;
+};
+
+static std::vector<Benchmark> g_benchmarks;
+static size_t g_max_n = 1000000;
+static double g_min_time = 0.1;
+
+//注册fn，n从1开始每次乘10，不超过limit和--max
+static void registerBench(const string &name, BenchFn fn, size_t limit = static_cast<size_t>(-1))
+{
+    for(size_t n = 1; n <= g_max_n && n <= limit; n *= 10)
+    {
+        Benchmark b = {name, fn, n};
+        g_benchmarks.push_back(b);
+    }
+}
+
+static void registerFixed(const string &name, BenchFn fn, size_t n)
+{
+    Benchmark b = {name, fn, n};
+    g_benchmarks.push_back(b);
+}
+
+static long peakRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static void runBench(const Benchmark &b)
+{
+    size_t iterations = 1;
+    for(;;)
+    {
+        State state(b.n, iterations);
+        b.fn(state);
+        if(state.elapsed() >= g_min_time || iterations >= 1000000000)
+        {
+            double items = static_cast<double>(state.items()) * iterations;
+            printf("%-44s %10zu %10zu %12.2f %12.2f %10ld\n",
+                   b.name.c_str(), b.n, iterations,
+                   state.elapsed() * 1e9 / (items > 0 ? items : 1),
+                   static_cast<double>(state.allocs()) / iterations,
+                   peakRssKb() / 1024);
+            return;
+        }
+        //按本次的耗时估计下一次需要的迭代次数，最多放大10倍
+        double scale = state.elapsed() > 0 ? g_min_time * 1.4 / state.elapsed() : 10;
+        size_t next = static_cast<size_t>(iterations * (scale < 10 ? scale : 10));
+        iterations = next > iterations ? next : iterations + 1;
+    }
+}
+
+//各种元素类型
+struct Large
+{
+    double values[32];
+    bool operator==(const Large &other) const
+    {   return memcmp(values, other.values, sizeof(values)) == 0;    }
+    bool operator<(const Large &other) const
+    {   return memcmp(values, other.values, sizeof(values)) < 0; }
+};
+
+template <typename T> T makeValue(size_t ix);
+
+template <>
+int makeValue<int>(size_t ix)
+{   return static_cast<int>(ix);    }
+
+template <>
+string makeValue<string>(size_t ix)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "a string longer than sso #%zu", ix);
+    return buf;
+}
+
+template <>
+Large makeValue<Large>(size_t ix)
+{
+    Large l;
+    for(int jx = 0; jx != 32; ++jx)
+        l.values[jx] = static_cast<double>(ix + jx);
+    return l;
+}
+
+inline size_t weight(int v) { return static_cast<size_t>(v); }
+inline size_t weight(const string &s) { return s.size(); }
+inline size_t weight(const Large &l) { return static_cast<size_t>(l.values[0]); }
+
+template <typename V>
+V makeContainer(size_t n)
+{
+    V vec;
+    vec.reserve(n);
+    for(size_t ix = 0; ix != n; ++ix)
+        vec.push_back(makeValue<typename V::value_type>(ix));
+    return vec;
+}
+
+//Vector与std::vector共用的用例
+template <typename V>
+void BM_PushBack(State &state)
+{
+    typedef typename V::value_type T;
+    T value = makeValue<T>(0);
+    while(state.keepRunning())
+    {
+        V vec;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+            vec.push_back(value);
+        doNotOptimize(vec.back());
+    }
+}
+
+template <typename V>
+void BM_ReservePushBack(State &state)
+{
+    typedef typename V::value_type T;
+    T value = makeValue<T>(0);
+    while(state.keepRunning())
+    {
+        V vec;
+        vec.reserve(state.range());
+        for(size_t ix = 0; ix != state.range(); ++ix)
+            vec.push_back(value);
+        doNotOptimize(vec.back());
+    }
+}
+
+template <typename V>
+void BM_InsertFront(State &state)
+{
+    typedef typename V::value_type T;
+    T value = makeValue<T>(0);
+    while(state.keepRunning())
+    {
+        V vec;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+            vec.insert(vec.begin(), value);
+        doNotOptimize(vec.back());
+    }
+}
+
+template <typename V>
+void BM_InsertMiddle(State &state)
+{
+    typedef typename V::value_type T;
+    T value = makeValue<T>(0);
+    while(state.keepRunning())
+    {
+        V vec;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+            vec.insert(vec.begin() + vec.size() / 2, value);
+        doNotOptimize(vec.back());
+    }
+}
+
+//每次从头部删除一个元素直到删空
+template <typename V>
+void BM_EraseFront(State &state)
+{
+    V src = makeContainer<V>(state.range());
+    while(state.keepRunning())
+    {
+        state.pauseTiming();
+        V vec(src);
+        state.resumeTiming();
+        while(!vec.empty())
+            vec.erase(vec.begin());
+        doNotOptimize(vec.size());
+    }
+}
+
+template <typename V>
+void BM_Resize(State &state)
+{
+    while(state.keepRunning())
+    {
+        V vec;
+        vec.resize(state.range());
+        doNotOptimize(vec.back());
+    }
+}
+
+//模拟read()填充缓冲区：先把大小调到range()，再用memcpy整块覆盖
+static void BM_ReadResize(State &state)
+{
+    Vector<char> src(state.range(), 'x');
+    while(state.keepRunning())
+    {
+        Vector<char> buf;
+        buf.resize(state.range());
+        memcpy(buf.data(), src.data(), src.size());
+        doNotOptimize(buf.back());
+    }
+}
+
+static void BM_ReadOverwrite(State &state)
+{
+    Vector<char> src(state.range(), 'x');
+    while(state.keepRunning())
+    {
+        Vector<char> buf;
+        buf.resize_and_overwrite(state.range(), [&src](char *p, size_t n) {
+            memcpy(p, src.data(), n);
+            return n;
+        });
+        doNotOptimize(buf.back());
+    }
+}
+
+template <typename V>
+void BM_RangeConstruct(State &state)
+{
+    std::vector<typename V::value_type> src = makeContainer<std::vector<typename V::value_type> >(state.range());
+    while(state.keepRunning())
+    {
+        V vec(src.begin(), src.end());
+        doNotOptimize(vec.back());
+    }
+}
+
+template <typename V>
+void BM_Copy(State &state)
+{
+    V src = makeContainer<V>(state.range());
+    while(state.keepRunning())
+    {
+        V vec(src);
+        doNotOptimize(vec.back());
+    }
+}
+
+//两个只有最后一个元素不同的容器
+template <typename V>
+void BM_Compare(State &state)
+{
+    V lhs = makeContainer<V>(state.range());
+    V rhs(lhs);
+    rhs.back() = makeValue<typename V::value_type>(state.range());
+    while(state.keepRunning())
+    {
+        bool less = lhs < rhs;
+        doNotOptimize(less);
+    }
+}
+
+template <typename V>
+void BM_Iterate(State &state)
+{
+    V vec = makeContainer<V>(state.range());
+    while(state.keepRunning())
+    {
+        size_t sum = 0;
+        for(typename V::const_iterator it = vec.begin(); it != vec.end(); ++it)
+            sum += weight(*it);
+        doNotOptimize(sum);
+    }
+}
+
+//在range()个元素中模拟编辑器：光标每次随机移动几格，然后插入或删除一个元素
+template <typename V>
+void BM_CursorEdit(State &state)
+{
+    const size_t kEdits = 10000;
+    V src(state.range(), 0);
+    state.setItemsPerIteration(kEdits);
+    while(state.keepRunning())
+    {
+        state.pauseTiming();
+        V vec(src);
+        size_t cursor = vec.size() / 2;
+        uint32_t seed = 12345;
+        state.resumeTiming();
+        for(size_t ix = 0; ix != kEdits; ++ix)
+        {
+            seed = seed * 1103515245 + 12345;
+            size_t step = (seed >> 16) % 17;
+            cursor = std::min(vec.size(), cursor + step > 8 ? cursor + step - 8 : 0);
+            if((seed >> 8) & 1 || cursor == vec.size())
+                vec.insert(vec.begin() + cursor, static_cast<int>(ix));
+            else
+                vec.erase(vec.begin() + cursor);
+        }
+        doNotOptimize(vec.size());
+    }
+}
+
+//insert、erase在头部和中间是O(n^2)，size_limit限制它们的规模
+template <typename V>
+void registerSuite(const string &name, size_t size_limit, size_t quadratic_limit)
+{
+    registerBench(name + "/push_back", BM_PushBack<V>, size_limit);
+    registerBench(name + "/reserve_push_back", BM_ReservePushBack<V>, size_limit);
+    registerBench(name + "/insert_front", BM_InsertFront<V>, quadratic_limit);
+    registerBench(name + "/insert_middle", BM_InsertMiddle<V>, quadratic_limit);
+    registerBench(name + "/erase_front", BM_EraseFront<V>, quadratic_limit);
+    registerBench(name + "/resize", BM_Resize<V>, size_limit);
+    registerBench(name + "/range_construct", BM_RangeConstruct<V>, size_limit);
+    registerBench(name + "/copy", BM_Copy<V>, size_limit);
+    registerBench(name + "/compare", BM_Compare<V>, size_limit);
+    registerBench(name + "/iterate", BM_Iterate<V>, size_limit);
+}
+
+//移动构造可能抛异常的string，Vector扩容时只能拷贝它
+struct CopyOnGrowString
+{
+    CopyOnGrowString(const char *s) :str(s) { }
+    CopyOnGrowString(const CopyOnGrowString &other) :str(other.str) { }
+    CopyOnGrowString(CopyOnGrowString &&other) noexcept(false) :str(std::move(other.str)) { }
+    string str;
+};
+
+//扩容时移动与拷贝的内存分配次数对比
+template <typename S>
+void BM_GrowStrings(State &state)
+{
+    const char *payload = "a string long enough to defeat the small string optimization";
+    while(state.keepRunning())
+    {
+        Vector<S> vec;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+            vec.push_back(S(payload));
+        doNotOptimize(vec.size());
+    }
+}
+
+//每次请求新建一批只有8个元素的小Vector，用完整体丢弃
+static void BM_ArenaRequest(State &state)
+{
+    while(state.keepRunning())
+    {
+        Arena request_arena;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+        {
+            Vector<int, ArenaAllocator<int> > v((ArenaAllocator<int>(request_arena)));
+            for(int jx = 0; jx != 8; ++jx)
+                v.push_back(jx);
+            doNotOptimize(v.back());
+        }
+    }
+}
+
+static void BM_HeapRequest(State &state)
+{
+    while(state.keepRunning())
+    {
+        for(size_t ix = 0; ix != state.range(); ++ix)
+        {
+            Vector<int> v;
+            for(int jx = 0; jx != 8; ++jx)
+                v.push_back(jx);
+            doNotOptimize(v.back());
+        }
+    }
+}
+
+//创建、填充、遍历并销毁只有6个元素的容器
+template <typename V>
+void BM_Tiny(State &state)
+{
+    state.setItemsPerIteration(1);
+    while(state.keepRunning())
+    {
+        V vec;
+        for(int ix = 0; ix != 6; ++ix)
+            vec.push_back(ix);
+        long sum = 0;
+        for(typename V::const_iterator it = vec.begin(); it != vec.end(); ++it)
+            sum += *it;
+        doNotOptimize(sum);
+    }
+}
+
+template <typename V>
+void BM_AppendDouble(State &state)
+{
+    while(state.keepRunning())
+    {
+        V vec;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+            vec.push_back(static_cast<double>(ix));
+        doNotOptimize(vec.back());
+    }
+}
+
+//y += a * x，编译器会向量化这个循环，缓冲区对齐时没有跨缓存行的读写
+template <typename V>
+void BM_Axpy(State &state)
+{
+    V x(state.range(), 1.0f), y(state.range(), 2.0f);
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        const float *px = x.data();
+        float *py = y.data();
+        for(size_t ix = 0, n = y.size(); ix != n; ++ix)
+            py[ix] += 0.5f * px[ix];
+        doNotOptimize(y.back());
+    }
+}
+
+//把一份4MB的只读表分给range()个worker，每个worker读一个元素
+template <typename V>
+void BM_FanOut(State &state)
+{
+    V table(size_t(1) << 20, 42);
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        Vector<V> workers;
+        workers.reserve(state.range());
+        long sum = 0;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+        {
+            workers.push_back(table);
+            sum += workers.back()[ix];
+        }
+        doNotOptimize(sum);
+    }
+}
+
+//过期清理：删除大约四分之一的元素，位置随机
+static bool expired(int v)
+{
+    uint32_t h = static_cast<uint32_t>(v);
+    h = (h ^ (h >> 16)) * 0x45d9f3bu;
+    h = (h ^ (h >> 16)) * 0x45d9f3bu;
+    return (h ^ (h >> 16)) % 4 == 0;
+}
+
+template <typename V>
+void BM_ExpireEraseLoop(State &state)
+{
+    V src = makeContainer<V>(state.range());
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        state.pauseTiming();
+        V vec(src);
+        state.resumeTiming();
+        for(typename V::iterator it = vec.begin(); it != vec.end(); )
+        {
+            if(expired(*it))
+                it = vec.erase(it);
+            else
+                ++it;
+        }
+        doNotOptimize(vec.size());
+    }
+}
+
+template <typename V>
+void BM_ExpireEraseIf(State &state)
+{
+    V src = makeContainer<V>(state.range());
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        state.pauseTiming();
+        V vec(src);
+        state.resumeTiming();
+        vec.erase_if([](int v) { return expired(v); });
+        doNotOptimize(vec.size());
+    }
+}
+
+static void BM_ExpireRemoveIf(State &state)
+{
+    std::vector<int> src = makeContainer<std::vector<int> >(state.range());
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        state.pauseTiming();
+        std::vector<int> vec(src);
+        state.resumeTiming();
+        vec.erase(std::remove_if(vec.begin(), vec.end(), [](int v) { return expired(v); }), vec.end());
+        doNotOptimize(vec.size());
+    }
+}
+
+//range()个不重复的随机键，顺序打乱
+static Vector<std::pair<int, int> > randomEntries(size_t n)
+{
+    Vector<std::pair<int, int> > entries;
+    entries.reserve(n);
+    uint32_t seed = 2463534242u;
+    for(size_t ix = 0; ix != n; ++ix)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        entries.push_back(std::make_pair(static_cast<int>(ix * 2), static_cast<int>(seed)));
+    }
+    for(size_t ix = n; ix > 1; --ix)
+    {
+        seed = seed * 1103515245 + 12345;
+        std::swap(entries[ix - 1], entries[(seed >> 8) % ix]);
+    }
+    return entries;
+}
+
+//批量建表，map.insert(first, last)
+template <typename M>
+void BM_MapBuild(State &state)
+{
+    Vector<std::pair<int, int> > entries = randomEntries(state.range());
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        M map;
+        map.insert(entries.begin(), entries.end());
+        doNotOptimize(map.size());
+    }
+}
+
+//逐个插入，FlatMap每次要移动后面的元素
+template <typename M>
+void BM_MapInsertEach(State &state)
+{
+    Vector<std::pair<int, int> > entries = randomEntries(state.range());
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        M map;
+        for(size_t ix = 0; ix != entries.size(); ++ix)
+            map.insert(entries[ix]);
+        doNotOptimize(map.size());
+    }
+}
+
+//随机查找，一半的键存在
+template <typename M>
+void BM_MapLookup(State &state)
+{
+    Vector<std::pair<int, int> > entries = randomEntries(state.range());
+    M map(entries.begin(), entries.end());
+    const size_t kLookups = 1000;
+    state.setItemsPerIteration(kLookups);
+    uint32_t seed = 1;
+    while(state.keepRunning())
+    {
+        long found = 0;
+        for(size_t ix = 0; ix != kLookups; ++ix)
+        {
+            seed = seed * 1103515245 + 12345;
+            typename M::const_iterator it = map.find(static_cast<int>((seed >> 4) % (2 * state.range())));
+            if(it != map.end())
+                found += it->second;
+        }
+        doNotOptimize(found);
+    }
+}
+
+//按位保存和逐字节保存的bool序列，约1/4为true
+template <typename V>
+V makeFlags(size_t n, uint32_t salt)
+{
+    V flags;
+    flags.reserve(n);
+    for(size_t ix = 0; ix != n; ++ix)
+        flags.push_back(expired(static_cast<int>(ix ^ salt)));
+    return flags;
+}
+
+static size_t countFlags(const BitVector<> &flags) { return flags.count(); }
+static size_t countFlags(const Vector<bool> &flags) { return std::count(flags.begin(), flags.end(), true); }
+
+static void andFlags(BitVector<> &lhs, const BitVector<> &rhs) { lhs &= rhs; }
+static void andFlags(Vector<bool> &lhs, const Vector<bool> &rhs)
+{
+    for(size_t ix = 0; ix != lhs.size(); ++ix)
+        lhs[ix] = lhs[ix] & rhs[ix];
+}
+
+static size_t sumSetPositions(const BitVector<> &flags)
+{
+    size_t sum = 0;
+    for(size_t pos = flags.find_first(); pos != BitVector<>::npos; pos = flags.find_next(pos))
+        sum += pos;
+    return sum;
+}
+static size_t sumSetPositions(const Vector<bool> &flags)
+{
+    size_t sum = 0;
+    for(size_t ix = 0; ix != flags.size(); ++ix)
+        if(flags[ix])
+            sum += ix;
+    return sum;
+}
+
+template <typename V>
+void BM_FlagsBuild(State &state)
+{
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        V flags = makeFlags<V>(state.range(), 0);
+        doNotOptimize(flags.size());
+    }
+}
+
+template <typename V>
+void BM_FlagsCount(State &state)
+{
+    V flags = makeFlags<V>(state.range(), 0);
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+        doNotOptimize(countFlags(flags));
+}
+
+template <typename V>
+void BM_FlagsAnd(State &state)
+{
+    V lhs = makeFlags<V>(state.range(), 0), rhs = makeFlags<V>(state.range(), 0x5bd1e995);
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        andFlags(lhs, rhs);
+        doNotOptimize(lhs.size());
+    }
+}
+
+template <typename V>
+void BM_FlagsScan(State &state)
+{
+    V flags = makeFlags<V>(state.range(), 0);
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+        doNotOptimize(sumSetPositions(flags));
+}
+
+//id列：sorted为true时是间隔1~64的递增id，否则是0~4095的随机id
+static Vector<uint32_t> makeIds(size_t n, bool sorted)
+{
+    Vector<uint32_t> ids;
+    ids.reserve(n);
+    uint32_t seed = 1, id = 0;
+    for(size_t ix = 0; ix != n; ++ix)
+    {
+        seed = seed * 1103515245 + 12345;
+        id = sorted ? id + 1 + (seed >> 16) % 64 : (seed >> 16) % 4096;
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+template <bool Sorted>
+void BM_IdScanRaw(State &state)
+{
+    Vector<uint32_t> ids = makeIds(state.range(), Sorted);
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        uint64_t sum = 0;
+        for(Vector<uint32_t>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+            sum += *it;
+        doNotOptimize(sum);
+    }
+}
+
+template <typename Coding>
+void BM_IdScanPacked(State &state)
+{
+    Vector<uint32_t> ids = makeIds(state.range(), Coding::delta);
+    PackedIntVector<uint32_t, Coding> packed(ids.begin(), ids.end());
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        uint64_t sum = 0;
+        packed.for_each([&sum](uint32_t id) { sum += id; });
+        doNotOptimize(sum);
+    }
+}
+
+static void BM_IdIteratePacked(State &state)
+{
+    Vector<uint32_t> ids = makeIds(state.range(), false);
+    PackedIntVector<uint32_t> packed(ids.begin(), ids.end());
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        uint64_t sum = 0;
+        for(PackedIntVector<uint32_t>::const_iterator it = packed.begin(); it != packed.end(); ++it)
+            sum += *it;
+        doNotOptimize(sum);
+    }
+}
+
+//逐个追加，每满一块编码一次；块表要按倍数增长，否则追加是平方复杂度
+static void BM_IdPushBackPacked(State &state)
+{
+    Vector<uint32_t> ids = makeIds(state.range(), false);
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        PackedIntVector<uint32_t> packed;
+        for(Vector<uint32_t>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+            packed.push_back(*it);
+        doNotOptimize(packed.size());
+    }
+}
+
+//随机位置读取1000次
+template <typename V>
+void BM_IdRandomAccess(State &state)
+{
+    Vector<uint32_t> ids = makeIds(state.range(), false);
+    V vec(ids.begin(), ids.end());
+    const size_t kLookups = 1000;
+    state.setItemsPerIteration(kLookups);
+    uint32_t seed = 1;
+    while(state.keepRunning())
+    {
+        uint64_t sum = 0;
+        for(size_t ix = 0; ix != kLookups; ++ix)
+        {
+            seed = seed * 1103515245 + 12345;
+            sum += vec[(seed >> 4) % state.range()];
+        }
+        doNotOptimize(sum);
+    }
+}
+
+//工作队列：先放入range()个任务，之后每取出一个任务就放入一个新任务，共处理range()个
+static void popFront(Vector<int> &queue) { queue.erase(queue.begin()); }
+static void popFront(RingVector<int> &queue) { queue.pop_front(); }
+static void popFront(std::deque<int> &queue) { queue.pop_front(); }
+
+template <typename Q>
+void BM_WorkQueue(State &state)
+{
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        Q queue;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+            queue.push_back(static_cast<int>(ix));
+        long sum = 0;
+        for(size_t ix = 0; ix != state.range(); ++ix)
+        {
+            sum += queue.front();
+            popFront(queue);
+            queue.push_back(static_cast<int>(ix));
+        }
+        doNotOptimize(sum);
+    }
+}
+
+static void BM_MappedOpen(State &state)
+{
+    const char *path = "/tmp/vector_bench_mapped.bin";
+    unlink(path);
+    {
+        MappedVector<double> vec(path);
+        for(size_t ix = 0; ix != state.range(); ++ix)
+            vec.push_back(static_cast<double>(ix));
+    }
+    state.setItemsPerIteration(1);
+    while(state.keepRunning())
+    {
+        const MappedVector<double> vec = MappedVector<double>::open_readonly(path);
+        doNotOptimize(vec.size());
+    }
+    unlink(path);
+}
+
+//range()个线程一起追加kTotal个元素
+static const size_t kConcurrentTotal = 1 << 20;
+
+static void BM_ConcurrentPush(State &state)
+{
+    size_t threads = state.range(), per_thread = kConcurrentTotal / threads;
+    state.setItemsPerIteration(per_thread * threads);
+    while(state.keepRunning())
+    {
+        ConcurrentVector<int> cv;
+        std::vector<std::thread> workers;
+        for(size_t t = 0; t != threads; ++t)
+            workers.push_back(std::thread([&cv, per_thread]() {
+                for(size_t ix = 0; ix != per_thread; ++ix)
+                    cv.push_back(static_cast<int>(ix));
+            }));
+        for(size_t t = 0; t != threads; ++t)
+            workers[t].join();
+        doNotOptimize(cv.size());
+    }
+}
+
+//对照：用互斥锁保护的Vector
+static void BM_MutexPush(State &state)
+{
+    size_t threads = state.range(), per_thread = kConcurrentTotal / threads;
+    state.setItemsPerIteration(per_thread * threads);
+    while(state.keepRunning())
+    {
+        Vector<int> vec;
+        std::mutex mu;
+        std::vector<std::thread> workers;
+        for(size_t t = 0; t != threads; ++t)
+            workers.push_back(std::thread([&vec, &mu, per_thread]() {
+                for(size_t ix = 0; ix != per_thread; ++ix)
+                {
+                    std::lock_guard<std::mutex> lock(mu);
+                    vec.push_back(static_cast<int>(ix));
+                }
+            }));
+        for(size_t t = 0; t != threads; ++t)
+            workers[t].join();
+        doNotOptimize(vec.size());
+    }
+}
+
+//大数组的串行与并行填充、拷贝和析构，range()是元素个数
+static void BM_FillSerial(State &state)
+{
+    while(state.keepRunning())
+    {
+        Vector<double> vec(state.range(), 1.0);
+        doNotOptimize(vec.back());
+    }
+}
+
+static void BM_FillParallel(State &state)
+{
+    while(state.keepRunning())
+    {
+        Vector<double> vec(par, state.range(), 1.0);
+        doNotOptimize(vec.back());
+    }
+}
+
+static void BM_CopySerial(State &state)
+{
+    Vector<double> src(par, state.range(), 1.0);
+    while(state.keepRunning())
+    {
+        Vector<double> vec(src);
+        doNotOptimize(vec.back());
+    }
+}
+
+static void BM_CopyParallel(State &state)
+{
+    Vector<double> src(par, state.range(), 1.0);
+    while(state.keepRunning())
+    {
+        Vector<double> vec;
+        vec.copy_from(par, src);
+        doNotOptimize(vec.back());
+    }
+}
+
+struct Owner
+{
+    Owner() :p(new int(0)) { }
+    Owner(const Owner &other) noexcept :p(new int(*other.p)) { }
+    ~Owner() { delete p; }
+    int *p;
+};
+
+static void BM_ClearSerial(State &state)
+{
+    while(state.keepRunning())
+    {
+        state.pauseTiming();
+        Vector<Owner> vec(par, state.range());
+        state.resumeTiming();
+        vec.clear();
+    }
+}
+
+static void BM_ClearParallel(State &state)
+{
+    while(state.keepRunning())
+    {
+        state.pauseTiming();
+        Vector<Owner> vec(par, state.range());
+        state.resumeTiming();
+        vec.clear(par);
+    }
+}
+
+//一行8个字段的订单记录，扫描只用到其中的price和qty
+struct Order
+{
+    double price;
+    int qty;
+    int side;
+    long id;
+    long account;
+    double fee;
+    long timestamp;
+    double limit;
+};
+
+typedef SoAVector<double, int, int, long, long, double, long, double> OrderColumns;
+
+static void BM_ScanRows(State &state)
+{
+    Vector<Order> orders;
+    for(size_t ix = 0; ix != state.range(); ++ix)
+    {
+        Order o = { 1.0 + ix % 100, static_cast<int>(ix % 7), 0, 0, 0, 0, 0, 0 };
+        orders.push_back(o);
+    }
+    state.setItemsPerIteration(state.range());
+    while(state.keepRunning())
+    {
+        double sum = 0;
+        for(Vector<Order>::const_iterator it = orders.begin(); it != orders.end(); ++it)
+            sum += it->price * it->qty;
+        doNotOptimize(sum);
+    }
+}
+
+static void BM_ScanColumns(State &state)
+{
+    OrderColumns orders;
+    orders.reserve(state.range());
+    for(size_t ix = 0; ix != state.range(); ++ix)
+        orders.push_back(1.0 + ix % 100, static_cast<int>(ix % 7), 0, 0, 0, 0, 0, 0);
+    state.setItemsPerIteration(state.range());
+    const OrderColumns &columns = orders;
+    while(state.keepRunning())
+    {
+        VectorView<const double> price = columns.column<0>();
+        VectorView<const int> qty = columns.column<1>();
+        double sum = 0;
+        for(size_t ix = 0; ix != price.size(); ++ix)
+            sum += price[ix] * qty[ix];
+        doNotOptimize(sum);
+    }
+}
+
+static void registerAll()
+{
+    size_t max = static_cast<size_t>(-1);
+    registerSuite<Vector<int> >("Vector<int>", max, 10000);
+    registerSuite<std::vector<int> >("std::vector<int>", max, 10000);
+    registerBench("GapVector<int>/insert_front", BM_InsertFront<GapVector<int> >, max);
+    registerBench("GapVector<int>/insert_middle", BM_InsertMiddle<GapVector<int> >, max);
+    registerBench("GapVector<int>/erase_front", BM_EraseFront<GapVector<int> >, max);
+    registerBench("Vector<int>/cursor_edit", BM_CursorEdit<Vector<int> >, max);
+    registerBench("GapVector<int>/cursor_edit", BM_CursorEdit<GapVector<int> >, max);
+    registerBench("Vector<char>/read_resize", BM_ReadResize, max);
+    registerBench("Vector<char>/read_resize_and_overwrite", BM_ReadOverwrite, max);
+    registerBench("Vector<int>/expire_erase_loop", BM_ExpireEraseLoop<Vector<int> >, 100000);
+    registerBench("Vector<int>/expire_erase_if", BM_ExpireEraseIf<Vector<int> >, max);
+    registerBench("std::vector<int>/expire_remove_if", BM_ExpireRemoveIf, max);
+    registerBench("FlatMap<int, int>/build", BM_MapBuild<FlatMap<int, int> >, 1000000);
+    registerBench("std::map<int, int>/build", BM_MapBuild<std::map<int, int> >, 1000000);
+    registerBench("std::unordered_map<int, int>/build", BM_MapBuild<std::unordered_map<int, int> >, 1000000);
+    registerBench("FlatMap<int, int>/insert_each", BM_MapInsertEach<FlatMap<int, int> >, 10000);
+    registerBench("std::map<int, int>/insert_each", BM_MapInsertEach<std::map<int, int> >, 10000);
+    registerBench("FlatMap<int, int>/lookup", BM_MapLookup<FlatMap<int, int> >, 1000000);
+    registerBench("std::map<int, int>/lookup", BM_MapLookup<std::map<int, int> >, 1000000);
+    registerBench("std::unordered_map<int, int>/lookup", BM_MapLookup<std::unordered_map<int, int> >, 1000000);
+    registerBench("BitVector<>/flags_build", BM_FlagsBuild<BitVector<> >, max);
+    registerBench("Vector<bool>/flags_build", BM_FlagsBuild<Vector<bool> >, max);
+    registerBench("BitVector<>/flags_count", BM_FlagsCount<BitVector<> >, max);
+    registerBench("Vector<bool>/flags_count", BM_FlagsCount<Vector<bool> >, max);
+    registerBench("BitVector<>/flags_and", BM_FlagsAnd<BitVector<> >, max);
+    registerBench("Vector<bool>/flags_and", BM_FlagsAnd<Vector<bool> >, max);
+    registerBench("BitVector<>/flags_scan", BM_FlagsScan<BitVector<> >, max);
+    registerBench("Vector<bool>/flags_scan", BM_FlagsScan<Vector<bool> >, max);
+    registerBench("Vector<uint32_t>/id_scan", BM_IdScanRaw<false>, max);
+    registerBench("PackedIntVector<uint32_t>/id_scan", BM_IdScanPacked<FrameOfReference>, max);
+    registerBench("PackedIntVector<uint32_t>/id_iterate", BM_IdIteratePacked, max);
+    registerBench("Vector<uint32_t>/sorted_id_scan", BM_IdScanRaw<true>, max);
+    registerBench("PackedIntVector<uint32_t, DeltaCoding>/sorted_id_scan", BM_IdScanPacked<DeltaCoding>, max);
+    registerBench("Vector<uint32_t>/id_random_access", BM_IdRandomAccess<Vector<uint32_t> >, max);
+    registerBench("PackedIntVector<uint32_t>/id_random_access",
+                  BM_IdRandomAccess<PackedIntVector<uint32_t> >, max);
+    registerBench("Vector<int>/work_queue", BM_WorkQueue<Vector<int> >, 100000);
+    registerBench("RingVector<int>/work_queue", BM_WorkQueue<RingVector<int> >, max);
+    registerBench("std::deque<int>/work_queue", BM_WorkQueue<std::deque<int> >, max);
+    registerBench("Vector<float>/axpy", BM_Axpy<Vector<float> >, max);
+    registerBench("Vector<float, AlignedAllocator<float, 64>>/axpy",
+                  BM_Axpy<Vector<float, AlignedAllocator<float, 64> > >, max);
+    registerBench("Vector<Order>/scan", BM_ScanRows, max);
+    registerBench("SoAVector<Order fields>/scan", BM_ScanColumns, max);
+    registerSuite<Vector<string> >("Vector<string>", 1000000, 10000);
+    registerSuite<std::vector<string> >("std::vector<string>", 1000000, 10000);
+    registerSuite<Vector<Large> >("Vector<Large>", 100000, 1000);
+    registerSuite<std::vector<Large> >("std::vector<Large>", 100000, 1000);
+
+    registerFixed("Vector<string>/grow_strings", BM_GrowStrings<string>, 100000);
+    registerFixed("Vector<CopyOnGrowString>/grow_strings", BM_GrowStrings<CopyOnGrowString>, 100000);
+    registerFixed("Vector<double>/append", BM_AppendDouble<Vector<double> >, 2000000);
+    registerFixed("Vector<double, MallocAllocator>/append",
+                  BM_AppendDouble<Vector<double, MallocAllocator<double> > >, 2000000);
+    registerFixed("Vector<int, ArenaAllocator>/request", BM_ArenaRequest, 1000);
+    registerFixed("Vector<int>/request", BM_HeapRequest, 1000);
+    registerFixed("Vector<int>/tiny", BM_Tiny<Vector<int> >, 6);
+    registerFixed("SmallVector<int, 8>/tiny", BM_Tiny<SmallVector<int, 8> >, 6);
+    registerFixed("Vector<int>/fan_out_4MB", BM_FanOut<Vector<int> >, 32);
+    registerFixed("CowVector<int>/fan_out_4MB", BM_FanOut<CowVector<int> >, 32);
+    registerFixed("PackedIntVector<uint32_t>/push_back_8M", BM_IdPushBackPacked, 8000000);
+    registerFixed("MappedVector<double>/open_readonly", BM_MappedOpen, 100000);
+    registerFixed("Vector<double>/fill_serial", BM_FillSerial, 1 << 24);
+    registerFixed("Vector<double>/fill_par", BM_FillParallel, 1 << 24);
+    registerFixed("Vector<double>/copy_serial", BM_CopySerial, 1 << 24);
+    registerFixed("Vector<double>/copy_from_par", BM_CopyParallel, 1 << 24);
+    registerFixed("Vector<Owner>/clear_serial", BM_ClearSerial, 1 << 20);
+    registerFixed("Vector<Owner>/clear_par", BM_ClearParallel, 1 << 20);
+    for(size_t threads = 1; threads <= 8; threads *= 2)
+    {
+        registerFixed("ConcurrentVector<int>/push_back_threads", BM_ConcurrentPush, threads);
+        registerFixed("Vector<int>+mutex/push_back_threads", BM_MutexPush, threads);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = NULL;
+    for(int ix = 1; ix != argc; ++ix)
+    {
+        if(strncmp(argv[ix], "--max=", 6) == 0)
+            g_max_n = static_cast<size_t>(atof(argv[ix] + 6));
+        else if(strncmp(argv[ix], "--min-time=", 11) == 0)
+            g_min_time = atof(argv[ix] + 11);
+        else
+            filter = argv[ix];
+    }
+
+    registerAll();
+    printf("%-44s %10s %10s %12s %12s %10s\n",
+           "benchmark", "n", "iters", "ns/elem", "allocs/iter", "peak MB");
+    for(size_t ix = 0; ix != g_benchmarks.size(); ++ix)
+    {
+        const Benchmark &b = g_benchmarks[ix];
+        if(filter == NULL || b.name.find(filter) != string::npos)
+            runBench(b);
+    }
+    return 0;
+}
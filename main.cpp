@@ -1,9 +1,145 @@
 #include "Vector.hpp"
+#include "Allocator.hpp"
+#include "SmallVector.hpp"
+#include "MappedVector.hpp"
+#include "VectorIO.hpp"
+#include "VectorStats.hpp"
+#include "ConcurrentVector.hpp"
+#include "VectorView.hpp"
+#include "GapVector.hpp"
+#include "SoAVector.hpp"
+#include "CowVector.hpp"
+#include "FlatMap.hpp"
+#include "VectorTrim.hpp"
+#include "BitVector.hpp"
+#include "PackedIntVector.hpp"
+#include "RingVector.hpp"
 #include <iostream>
 #include <string>
 #include <assert.h>
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include <sstream>
+#include <iterator>
+#include <list>
+#include <deque>
+#include <algorithm>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <thread>
 using namespace std;
 
+//统计operator new的调用次数，用于观察扩容时的内存分配，多个线程会同时分配
+static std::atomic<size_t> g_alloc_count(0);
+
+void *operator new(size_t n)
+{
+    ++g_alloc_count;
+    void *p = malloc(n ? n : 1);
+    if(p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+//stable_sort等使用的nothrow版本也要替换，否则会与下面的operator delete不配对
+void *operator new(size_t n, const std::nothrow_t &) noexcept
+{
+    ++g_alloc_count;
+    return malloc(n ? n : 1);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+//持有堆内存的句柄，可以按字节搬迁
+struct Handle
+{
+    explicit Handle(int v = 0) :p(new int(v)) { ++live; }
+    Handle(const Handle &other) :p(new int(*other.p)) { ++live; }
+    Handle &operator=(const Handle &other) { *p = *other.p; return *this; }
+    ~Handle() { delete p; --live; }
+    int *p;
+    static std::atomic<int> live; //并行析构时多个线程同时修改
+};
+std::atomic<int> Handle::live(0);
+
+template <>
+struct is_trivially_relocatable<Handle> : std::true_type { };
+
+//记录默认构造的次数
+struct Counted
+{
+    Counted() { ++made; }
+    static int made;
+};
+int Counted::made = 0;
+
+//g_alloc_fail为true时分配失败的分配器，所有rebind出来的类型共用这个开关
+static std::atomic<bool> g_alloc_fail(false);
+
+template <typename T>
+struct FlakyAllocator
+{
+    typedef T value_type;
+
+    FlakyAllocator() { }
+    template <typename U>
+    FlakyAllocator(const FlakyAllocator<U> &) { }
+
+    T *allocate(size_t n)
+    {
+        if(g_alloc_fail)
+            throw std::bad_alloc();
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, size_t n) { std::allocator<T>().deallocate(p, n); }
+};
+
+template <typename T, typename U>
+bool operator==(const FlakyAllocator<T> &, const FlakyAllocator<U> &) { return true; }
+template <typename T, typename U>
+bool operator!=(const FlakyAllocator<T> &, const FlakyAllocator<U> &) { return false; }
+
+//带编号的分配器，编号不同的互不相等，swap时不传播
+template <typename T>
+struct TaggedAllocator
+{
+    typedef T value_type;
+
+    explicit TaggedAllocator(int t = 0) :tag(t) { }
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U> &other) :tag(other.tag) { }
+
+    T *allocate(size_t n) { return std::allocator<T>().allocate(n); }
+    void deallocate(T *p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    int tag;
+};
+
+template <typename T, typename U>
+bool operator==(const TaggedAllocator<T> &lhs, const TaggedAllocator<U> &rhs) { return lhs.tag == rhs.tag; }
+template <typename T, typename U>
+bool operator!=(const TaggedAllocator<T> &lhs, const TaggedAllocator<U> &rhs) { return lhs.tag != rhs.tag; }
+
+//参数不依赖N
+static int sumSmall(const SmallVectorImpl<int> &vec)
+{
+    int sum = 0;
+    for(SmallVectorImpl<int>::const_iterator it = vec.begin(); it != vec.end(); ++it)
+        sum += *it;
+    return sum;
+}
+
+static void appendSmall(SmallVectorImpl<int> &vec, int n)
+{
+    for(int ix = 0; ix != n; ++ix)
+        vec.push_back(ix);
+}
+
 
 template <typename T>
 void print(const T &t)
@@ -133,7 +269,8 @@ int main(int argc, char const *argv[])
 
     { //测试resize
         Vector<int> vec(static_cast<Vector<int>::size_type>(17), 15);
-        //Vector<int> vec(10, 10); 编译错误
+        Vector<int> vec2(10, 10); //不再误用迭代器区间的构造函数
+        assert(vec2.size() == 10 && vec2[9] == 10);
         print(vec);
         printInfo(vec);
         vec.resize(20, 13);
@@ -185,6 +322,1545 @@ int main(int argc, char const *argv[])
         cout << vec.max_size() << endl;
     }
 
+    { //测试移动语义
+        Vector<string> vec(static_cast<Vector<string>::size_type>(3), "foo");
+        Vector<string>::iterator data = vec.begin();
+        Vector<string> vec2(std::move(vec));
+        assert(vec.empty() && vec.capacity() == 0);
+        assert(vec2.begin() == data && vec2.size() == 3);
+
+        vec = std::move(vec2);
+        assert(vec2.empty());
+        assert(vec.begin() == data && vec.size() == 3);
+
+        string s("bar");
+        vec.push_back(std::move(s));
+        assert(vec.back() == "bar");
+
+        vec.emplace_back(3, 'x');
+        assert(vec.back() == "xxx");
+        assert(vec.size() == 5);
+
+        //参数引用容器自身的元素
+        while(vec.size() != vec.capacity())
+            vec.push_back("pad");
+        vec.push_back(vec[0]);
+        assert(vec.back() == "foo");
+
+        Vector<string>::iterator it = vec.emplace(vec.begin() + 1, "baz");
+        assert(it == vec.begin() + 1 && *it == "baz");
+        it = vec.insert(vec.begin(), vec[1]);
+        assert(it == vec.begin() && *it == "baz");
+        it = vec.emplace(vec.end(), "end");
+        assert(it == vec.end() - 1 && *it == "end");
+        print(vec);
+
+        Vector<Vector<string> > nested;
+        for(int ix = 0; ix != 10; ++ix)
+            nested.push_back(Vector<string>(static_cast<Vector<string>::size_type>(4), "foo"));
+        assert(nested.size() == 10 && nested[9].size() == 4);
+        cout << "测试移动语义无错误" << endl;
+    }
+
+    { //测试按字节搬迁
+        Vector<int, MallocAllocator<int> > vec;
+        for(int ix = 0; ix != 1000000; ++ix)
+            vec.push_back(ix);
+        assert(vec.size() == 1000000 && vec[999999] == 999999);
+        vec.insert(vec.begin() + 1, static_cast<size_t>(3), -1);
+        assert(vec[0] == 0 && vec[1] == -1 && vec[3] == -1 && vec[4] == 1);
+        vec.erase(vec.begin(), vec.begin() + 4);
+        assert(vec[0] == 1 && vec.size() == 999999);
+        vec.resize(10);
+        assert(vec.back() == 10 && vec.size() == 10);
+
+        {
+            Vector<Handle> hs;
+            for(int ix = 0; ix != 10; ++ix)
+                hs.push_back(Handle(ix));
+            hs.insert(hs.begin(), static_cast<size_t>(2), Handle(-1));
+            hs.emplace(hs.begin() + 5, 100);
+            hs.erase(hs.begin());
+            hs.erase(hs.begin() + 1, hs.begin() + 3);
+            assert(hs.size() == 10);
+            assert(*hs[0].p == -1 && *hs[1].p == 2 && *hs[3].p == 3 && *hs[9].p == 9);
+            assert(Handle::live == 10);
+        }
+        assert(Handle::live == 0);
+        cout << "测试按字节搬迁无错误" << endl;
+    }
+
+    { //测试分配器
+        //无状态的分配器不占空间
+        assert(sizeof(Vector<int>) == 3 * sizeof(int *));
+        assert(sizeof(Vector<int, MallocAllocator<int> >) == 3 * sizeof(int *));
+        assert(sizeof(Vector<int, ArenaAllocator<int> >) == 4 * sizeof(int *));
+
+        Arena arena(1024);
+        typedef Vector<string, ArenaAllocator<string> > ArenaVec;
+        ArenaVec vec((ArenaAllocator<string>(arena)));
+        for(int ix = 0; ix != 100; ++ix)
+            vec.push_back("arena");
+        assert(vec.size() == 100 && vec.get_allocator().arena() == &arena);
+
+        ArenaVec copy(vec); //拷贝使用同一个Arena
+        assert(copy == vec && copy.get_allocator() == vec.get_allocator());
+
+        Arena other;
+        ArenaVec vec2(static_cast<ArenaVec::size_type>(3), "other", ArenaAllocator<string>(other));
+        vec2 = std::move(vec); //分配器随内存一起移动
+        assert(vec2.size() == 100 && vec2.get_allocator().arena() == &arena);
+        ArenaVec vec3(std::move(copy), ArenaAllocator<string>(other)); //分配器不同，逐个移动
+        assert(vec3.size() == 100 && copy.size() == 100 && copy[0].empty());
+        vec3.swap(vec2);
+        assert(vec3.get_allocator().arena() == &arena && vec2.get_allocator().arena() == &other);
+
+        //Arena中最后一次分配可以原地扩展
+        Vector<int, ArenaAllocator<int> > ints((ArenaAllocator<int>(other)));
+        ints.reserve(4);
+        int *data = ints.begin();
+        ints.reserve(64);
+        assert(ints.begin() == data);
+
+        PoolResource pool;
+        Vector<int, PoolAllocator<int> > pv((PoolAllocator<int>(pool)));
+        pv.reserve(8);
+        int *first = pv.begin();
+        pv.reserve(16);
+        Vector<int, PoolAllocator<int> > pv2((PoolAllocator<int>(pool)));
+        pv2.reserve(8); //复用刚刚释放的块
+        assert(pv2.begin() == first);
+        pv.resize(10000, 7); //大块走malloc
+        assert(pv[9999] == 7);
+        cout << "测试分配器无错误" << endl;
+    }
+
+    { //测试SmallVector
+        SmallVector<int, 8> sv;
+        size_t allocs = g_alloc_count;
+        appendSmall(sv, 8);
+        assert(sv.isSmall() && sv.capacity() == 8 && g_alloc_count == allocs);
+        assert(sumSmall(sv) == 28);
+        sv.push_back(8); //超过N，搬到堆上
+        assert(!sv.isSmall() && sv.size() == 9 && sv[8] == 8);
+
+        SmallVector<int, 8> copy(sv);
+        assert(copy == sv);
+        SmallVector<int, 8> moved(std::move(sv)); //堆上的内存直接接管
+        assert(moved == copy && sv.empty());
+        appendSmall(sv, 3); //被移走后重新使用内部缓冲区
+        assert(sv.isSmall() && sv.size() == 3);
+
+        SmallVector<string, 4> ss(static_cast<size_t>(2), "foo");
+        SmallVector<string, 4> ss2(static_cast<size_t>(3), "bar");
+        ss.swap(ss2);
+        assert(ss.size() == 3 && ss[2] == "bar" && ss2.size() == 2 && ss2[1] == "foo");
+        ss2 = std::move(ss);
+        assert(ss2.size() == 3 && ss.empty() && ss2.isSmall());
+        ss2.insert(ss2.begin(), static_cast<size_t>(5), "baz");
+        ss2.erase(ss2.begin() + 1, ss2.begin() + 4);
+        assert(ss2.size() == 5 && ss2[0] == "baz" && ss2[2] == "bar");
+        print(ss2);
+        cout << "测试SmallVector无错误" << endl;
+    }
+
+    { //测试增长策略
+        Vector<int, std::allocator<int>, GrowOneAndHalf> v15;
+        Vector<int, std::allocator<int>, GrowGolden> vg;
+        Vector<int, std::allocator<int>, GrowSizeClass<> > vs;
+        for(int ix = 0; ix != 1000; ++ix)
+        {
+            v15.push_back(ix);
+            vg.push_back(ix);
+            vs.push_back(ix);
+        }
+        assert(v15.size() == 1000 && v15.capacity() < 1500);
+        assert(vg.capacity() < 1618 && vs[999] == 999);
+        //vs的字节数正好落在某个size class上
+        size_t bytes = vs.capacity() * sizeof(int);
+        assert(GrowSizeClass<>::sizeClass(bytes) == bytes);
+        assert(GrowSizeClass<>::sizeClass(33) == 48 && GrowSizeClass<>::sizeClass(129) == 160);
+
+        //插入大量元素只重新分配一次
+        Vector<int> vec(static_cast<size_t>(4), 1);
+        size_t allocs = g_alloc_count;
+        vec.insert(vec.begin() + 2, static_cast<size_t>(1000), 7);
+        assert(g_alloc_count - allocs == 1 && vec.size() == 1004 && vec[1003] == 1);
+
+        bool thrown = false;
+        try
+        {
+            vec.reserve(vec.max_size() + 1);
+        }
+        catch(const std::length_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        thrown = false;
+        try
+        {
+            vec.insert(vec.end(), vec.max_size(), 0);
+        }
+        catch(const std::length_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown && vec.size() == 1004);
+        cout << "测试增长策略无错误" << endl;
+    }
+
+    { //测试不同类别的迭代器
+        //输入迭代器只能遍历一次
+        istringstream in("1 2 3 4 5");
+        Vector<int> vec((istream_iterator<int>(in)), istream_iterator<int>());
+        assert(vec.size() == 5 && vec[4] == 5);
+
+        istringstream in2("7 8");
+        vec.insert(vec.begin() + 1, istream_iterator<int>(in2), istream_iterator<int>());
+        int expect[] = {1, 7, 8, 2, 3, 4, 5};
+        assert(vec == Vector<int>(expect, expect + 7));
+
+        //前向迭代器只分配一次
+        list<string> words;
+        words.push_back("a");
+        words.push_back("b");
+        words.push_back("c");
+        size_t allocs = g_alloc_count;
+        Vector<string> ws(words.begin(), words.end());
+        assert(g_alloc_count - allocs == 1 && ws.capacity() == 3);
+        ws.insert(ws.begin() + 1, words.begin(), words.end());
+        assert(ws.size() == 6 && ws[1] == "a" && ws[4] == "b");
+
+        //assign复用已有的内存
+        Vector<int>::iterator data = vec.begin();
+        int small[] = {9, 9, 9};
+        vec.assign(small, small + 3);
+        assert(vec.begin() == data && vec.size() == 3 && vec[2] == 9);
+        istringstream in3("1 2 3 4 5 6");
+        vec.assign(istream_iterator<int>(in3), istream_iterator<int>());
+        assert(vec.begin() == data && vec.size() == 6 && vec[5] == 6);
+        vec.assign(static_cast<size_t>(2), vec[5]);
+        assert(vec.begin() == data && vec.size() == 2 && vec[1] == 6);
+
+        Vector<string> ws2(static_cast<size_t>(10), "x");
+        Vector<string>::iterator wdata = ws2.begin();
+        ws2 = ws;
+        assert(ws2.begin() == wdata && ws2 == ws);
+        cout << "测试迭代器类别无错误" << endl;
+    }
+
+    { //测试比较内核
+        Vector<uint8_t> b1(static_cast<size_t>(100), 7), b2(b1);
+        assert(b1 == b2 && compare(b1, b2) == 0);
+        b2[60] = 200;
+        assert(b1 < b2 && compare(b2, b1) > 0);
+        b2.pop_back();
+        assert(b1 < b2 && b1 != b2);
+
+        //有符号整数不能按字节定大小
+        Vector<int> i1(static_cast<size_t>(100), 1), i2(i1);
+        i1[77] = -1;
+        assert(i1 < i2 && i2 >= i1 && compare(i1, i2) < 0);
+        i2.push_back(0);
+        i1[77] = 1;
+        assert(i1 < i2 && i1 <= i2 && !(i1 == i2));
+
+        //+0和-0按字节不同但相等，NaN与任何值都不相等
+        Vector<double> d1(static_cast<size_t>(50), 0.0), d2(static_cast<size_t>(50), -0.0);
+        assert(d1 == d2 && compare(d1, d2) == 0);
+        d2[49] = 1.0;
+        assert(d1 < d2);
+        Vector<double> nan(static_cast<size_t>(3), numeric_limits<double>::quiet_NaN());
+        assert(nan != nan && compare(nan, nan) == 0);
+
+        Vector<string> s1(static_cast<size_t>(3), "abc"), s2(s1);
+        s2[2] = "abd";
+        assert(s1 < s2 && compare(s1, s2) < 0 && compare(s2, s1) > 0);
+        cout << "测试比较内核无错误" << endl;
+    }
+
+    { //测试MappedVector
+        struct Point { double x, y; };
+        const char *path = "/tmp/vector_mapped_test.bin";
+        unlink(path);
+        {
+            MappedVector<Point> points(path);
+            assert(points.empty());
+            for(int ix = 0; ix != 100000; ++ix)
+            {
+                Point p = {double(ix), -double(ix)};
+                points.push_back(p);
+            }
+            points.sync();
+            points.erase(points.begin(), points.begin() + 10);
+        }
+        {
+            MappedVector<Point> points(path); //重新打开，数据还在
+            assert(points.size() == 99990 && points[0].x == 10 && points.back().y == -99999);
+            Point p = {1, 2};
+            points.insert(points.begin(), static_cast<size_t>(5), p);
+            assert(points.size() == 99995);
+        }
+        {
+            const MappedVector<Point> points = MappedVector<Point>::open_readonly(path);
+            assert(points.size() == 99995 && points[4].y == 2 && points[5].x == 10);
+
+            MappedVector<Point> rw = MappedVector<Point>::open_readonly(path);
+            bool thrown = false;
+            try
+            {
+                rw.reserve(rw.capacity() + 1);
+            }
+            catch(const std::runtime_error &)
+            {
+                thrown = true;
+            }
+            assert(thrown);
+
+            //文件还有剩余容量，只读时追加也不能直接写进映射
+            assert(rw.capacity() == rw.size());
+            thrown = false;
+            try
+            {
+                Point p = {1, 2};
+                rw.push_back(p);
+            }
+            catch(const std::runtime_error &)
+            {
+                thrown = true;
+            }
+            assert(thrown && rw.size() == 99995 && rw.back().x == points.back().x);
+        }
+        {
+            MappedVector<double> a("/tmp/vector_mapped_a.bin"), b("/tmp/vector_mapped_b.bin");
+            a.assign(static_cast<size_t>(1000), 1.5);
+            b.assign(a.begin(), a.end());
+            assert(a == b && !(a < b));
+
+            //拷贝出的Vector在堆上，不和文件中的数据重叠
+            Vector<double, MmapAllocator<double> > copy(a);
+            assert(copy == a && copy.get_allocator().file() == NULL && copy.begin() != a.begin());
+            copy.push_back(2.5);
+            copy[0] = 3.5;
+            assert(a.size() == 1000 && a[0] == 1.5 && copy.size() == 1001);
+            a.assign(copy.begin(), copy.end()); //元素拷贝进文件
+            assert(a == copy && a.get_allocator() != copy.get_allocator());
+
+            //文件的数据区正在使用，不能再分配一块
+            MmapAllocator<double> alloc = a.get_allocator();
+            bool thrown = false;
+            try
+            {
+                alloc.allocate(10);
+            }
+            catch(const std::logic_error &)
+            {
+                thrown = true;
+            }
+            assert(thrown && a.size() == 1001 && a.back() == 2.5);
+        }
+        unlink(path);
+        unlink("/tmp/vector_mapped_a.bin");
+        unlink("/tmp/vector_mapped_b.bin");
+
+        bool thrown = false;
+        try
+        {
+            MappedVector<int>::open_readonly("/tmp/vector_mapped_missing.bin");
+        }
+        catch(const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        cout << "测试MappedVector无错误" << endl;
+    }
+
+    { //测试序列化
+        const char *path = "/tmp/vector_io_test.bin";
+        Vector<double> vec;
+        for(int ix = 0; ix != 100000; ++ix)
+            vec.push_back(ix * 0.5);
+
+        int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        write_to(fd, vec);
+        Vector<Vector<int> > nested;
+        for(int ix = 0; ix != 2000; ++ix) //超过IOV_MAX
+            nested.push_back(Vector<int>(static_cast<size_t>(ix % 7), ix));
+        write_to(fd, nested);
+
+        lseek(fd, 0, SEEK_SET);
+        Vector<double> back(static_cast<size_t>(3), 1.0);
+        read_from(fd, back);
+        assert(back == vec);
+        Vector<Vector<int> > nested_back;
+        read_from(fd, nested_back);
+        assert(nested_back == nested);
+        ::close(fd);
+
+        //空容器：数据部分长度为0，读取时不能当成文件结束
+        fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        write_to(fd, Vector<double>());
+        write_to(fd, Vector<Vector<int> >());
+        write_to(fd, vec);
+        lseek(fd, 0, SEEK_SET);
+        read_from(fd, back);
+        assert(back.empty());
+        read_from(fd, nested_back);
+        assert(nested_back.empty());
+        //文件被截断时抛出异常，原来的内容不变
+        ftruncate(fd, 3 * sizeof(VectorFileHeader) + sizeof(double));
+        back.push_back(1.5);
+        bool truncated = false;
+        try
+        {
+            read_from(fd, back);
+        }
+        catch(const std::runtime_error &)
+        {
+            truncated = true;
+        }
+        assert(truncated && back.size() == 1 && back[0] == 1.5);
+        ::close(fd);
+
+        //流
+        stringstream ss;
+        write_to(ss, vec);
+        string bytes = ss.str();
+        Vector<double> back2;
+        read_from(ss, back2);
+        assert(back2 == vec);
+
+        //视图指向已有的缓冲区
+        Vector<uint64_t> buf((bytes.size() + 7) / 8);
+        memcpy(buf.begin(), bytes.data(), bytes.size());
+        SerializedView<double> view = view_from<double>(buf.begin(), bytes.size(), true);
+        assert(view.size() == vec.size() && view[99999] == vec[99999]);
+        assert(static_cast<const void *>(view.begin()) == reinterpret_cast<char *>(buf.begin()) + sizeof(VectorFileHeader));
+
+        //数据损坏、类型不符
+        reinterpret_cast<char *>(buf.begin())[sizeof(VectorFileHeader) + 5] ^= 1;
+        bool thrown = false;
+        try
+        {
+            view_from<double>(buf.begin(), bytes.size(), true);
+        }
+        catch(const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        thrown = false;
+        try
+        {
+            view_from<int>(buf.begin(), bytes.size());
+        }
+        catch(const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        unlink(path);
+        cout << "测试序列化无错误" << endl;
+    }
+
+    { //测试统计策略
+        VECTOR_STATS_TAG(IntSite);
+        VECTOR_STATS_TAG(CopySite);
+        typedef Vector<int, std::allocator<int>, GrowDouble, VectorStats<IntSite> > IntVec;
+        assert(sizeof(IntVec) == sizeof(Vector<int>));
+        {
+            IntVec v;
+            for(int ix = 0; ix != 100; ++ix)
+                v.push_back(ix);
+        }
+        //容量依次为1, 2, 4, ..., 128
+        VectorStatsSnapshot s = VectorStats<IntSite>::site().snapshot();
+        assert(s.allocations == 8 && s.deallocations == 8 && s.regrowths == 8);
+        assert(s.bytes_allocated == 255 * sizeof(int) && s.bytes_freed == s.bytes_allocated);
+        assert(s.elements_moved == 127 && s.elements_copied == 0 && s.peak_capacity == 128);
+
+        //移动构造可能抛异常，搬迁时只能拷贝
+        struct Throwing
+        {
+            Throwing() { }
+            Throwing(const Throwing &) { }
+            Throwing(Throwing &&) noexcept(false) { }
+        };
+        {
+            Vector<Throwing, std::allocator<Throwing>, GrowDouble, VectorStats<CopySite> > v;
+            v.reserve(4);
+            for(int ix = 0; ix != 5; ++ix)
+                v.push_back(Throwing());
+        }
+        s = VectorStats<CopySite>::site().snapshot();
+        assert(s.regrowths == 2 && s.elements_copied == 4 && s.elements_moved == 0);
+
+        ostringstream os;
+        VectorStatsRegistry::instance().report(os);
+        string report = os.str();
+        assert(report.find("IntSite") < report.find("CopySite")); //按分配的字节数排序
+        assert(report.find("main.cpp:") != string::npos);
+        cout << report;
+        VectorStatsRegistry::instance().reset();
+        assert(VectorStats<IntSite>::site().snapshot().allocations == 0);
+        cout << "测试统计策略无错误" << endl;
+    }
+
+    { //测试ConcurrentVector
+        ConcurrentVector<int> cv;
+        size_t first = cv.push_back(-1);
+        int *stable = &cv[first];
+
+        const int kThreads = 4, kPerThread = 20000;
+        Vector<size_t> indices(static_cast<size_t>(kThreads * kPerThread));
+        Vector<std::thread> workers;
+        for(int t = 0; t != kThreads; ++t)
+        {
+            workers.push_back(std::thread([&cv, &indices, t]() {
+                for(int ix = 0; ix != kPerThread; ++ix)
+                {
+                    int value = t * kPerThread + ix;
+                    size_t n = cv.push_back(value);
+                    assert(cv[n] == value); //发布后马上可以读到
+                    indices[value] = n;
+                }
+            }));
+        }
+        for(size_t t = 0; t != workers.size(); ++t)
+            workers[t].join();
+
+        assert(cv.size() == 1 + kThreads * kPerThread);
+        assert(&cv[first] == stable && *stable == -1); //扩容不移动已有元素
+        for(int value = 0; value != kThreads * kPerThread; ++value)
+            assert(cv.ready(indices[value]) && cv[indices[value]] == value);
+        assert(!cv.ready(cv.size()));
+
+        Vector<int> snap = cv.snapshot();
+        assert(snap.size() == cv.size() && snap[first] == -1);
+        std::sort(snap.begin(), snap.end());
+        for(int value = 0; value != kThreads * kPerThread; ++value)
+            assert(snap[value + 1] == value);
+
+        ConcurrentVector<string> cs;
+        cs.emplace_back(static_cast<size_t>(3), 'x');
+        cs.push_back("concurrent");
+        assert(cs[0] == "xxx" && cs[1] == "concurrent" && cs.snapshot().size() == 2);
+
+        //段分配失败：提前分配的失败被忽略，需要新段的push_back抛出异常且不领取下标
+        typedef FlakyAllocator<int> Flaky;
+        ConcurrentVector<int, Flaky> fv;
+        for(int ix = 0; ix != 10; ++ix)
+            fv.push_back(ix);
+        g_alloc_fail = true;
+        for(int ix = 10; ix != 32; ++ix)
+            assert(fv.push_back(ix) == static_cast<size_t>(ix));
+        bool thrown = false;
+        try
+        {
+            fv.push_back(32);
+        }
+        catch(const std::bad_alloc &)
+        {
+            thrown = true;
+        }
+        g_alloc_fail = false;
+        assert(thrown && fv.size() == 32 && !fv.ready(32));
+        assert(fv.snapshot().size() == 32); //没有等不到的位置
+        assert(fv.push_back(32) == 32 && fv[32] == 32);
+        cout << "测试ConcurrentVector无错误" << endl;
+    }
+
+    { //测试并行批量操作
+        parallel_policy four(4, 4096); //数据量很小也分给4个线程
+        Vector<double> vd(four, static_cast<size_t>(100000), 1.5);
+        assert(vd.size() == 100000 && vd.capacity() == 100000);
+        assert(std::count(vd.begin(), vd.end(), 1.5) == 100000);
+
+        for(size_t ix = 0; ix != vd.size(); ++ix)
+            vd[ix] = static_cast<double>(ix);
+        Vector<double> copy;
+        copy.copy_from(four, vd);
+        assert(copy == vd);
+        copy.resize(four, 150001, -1.0);
+        assert(copy.size() == 150001 && copy[99999] == 99999 && copy[100000] == -1 && copy.back() == -1);
+        copy.resize(four, 10);
+        assert(copy.size() == 10 && copy[9] == 9);
+        copy.copy_from(par, vd); //默认策略，容量已经够用
+        assert(copy == vd);
+
+        Vector<double> small(par, static_cast<size_t>(3)); //数据太少，不开线程
+        assert(small.size() == 3 && small[2] == 0);
+
+        //拷贝可能抛异常的类型退化为串行，析构仍然并行
+        {
+            Vector<Handle> hs(four, static_cast<size_t>(5000), Handle(7));
+            assert(Handle::live == 5000 && *hs[4999].p == 7);
+            Vector<Handle> hs2;
+            hs2.copy_from(four, hs);
+            hs2.resize(four, 6000, Handle(8));
+            assert(Handle::live == 11000 && *hs2[5999].p == 8);
+            hs2.clear(four);
+            assert(hs2.empty() && Handle::live == 5000);
+            hs.resize(four, 100);
+            assert(Handle::live == 100);
+        }
+        assert(Handle::live == 0);
+
+        Vector<string> vs(four, static_cast<size_t>(2000), "parallel");
+        vs.clear(four);
+        assert(vs.empty() && vs.capacity() >= 2000);
+        cout << "测试并行批量操作无错误" << endl;
+    }
+
+    { //测试VectorView
+        Vector<int> v;
+        for(int ix = 0; ix != 10; ++ix)
+            v.push_back(ix);
+        VectorView<int> mid = v.slice(2, 5);
+        assert(mid.size() == 5 && mid.front() == 2 && mid.back() == 6 && mid.begin() == v.begin() + 2);
+        mid[0] = 100; //共享存储
+        assert(v[2] == 100);
+        v[2] = 2;
+        print(mid);
+
+        const Vector<int> &cv = v;
+        VectorView<const int> tail = cv.slice(7);
+        assert(tail.size() == 3 && tail[2] == 9 && v.slice(10).empty());
+        bool thrown = false;
+        try
+        {
+            v.slice(11);
+        }
+        catch(const std::out_of_range &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+
+        //视图与Vector可以直接比较
+        Vector<int> expect(mid.begin(), mid.end());
+        assert(mid == expect && expect == mid && !(mid != expect));
+        assert(v.slice(0, 3) < v.slice(1, 3) && compare(v.slice(0, 3), expect) < 0);
+        assert(mid.slice(1, 2) == v.slice(3, 2) && mid.slice(1, 2)[0] == 3);
+        assert(tail > mid && tail >= tail && mid <= expect);
+
+        //在流水线的各个阶段之间传递缓冲区，不拷贝元素
+        Vector<string> stage1(static_cast<size_t>(3), "payload");
+        string *payload = stage1.begin();
+        size_t n = stage1.size(), cap = stage1.capacity();
+        size_t allocs = g_alloc_count;
+        string *p = stage1.release();
+        assert(p == payload && stage1.empty() && stage1.capacity() == 0);
+        Vector<string> stage2;
+        stage2.adopt(p, n, cap);
+        assert(stage2.begin() == payload && stage2.size() == 3 && stage2[2] == "payload");
+        assert(g_alloc_count == allocs);
+
+        //与C接口交换malloc的内存
+        int *raw = static_cast<int *>(malloc(4 * sizeof(int)));
+        raw[0] = 1, raw[1] = 2, raw[2] = 3;
+        Vector<int, MallocAllocator<int> > mv;
+        mv.adopt(raw, 3, 4);
+        mv.push_back(4); //容量够，不需要重新分配
+        assert(mv.begin() == raw && mv.size() == 4 && mv.back() == 4);
+        int *out = mv.release();
+        assert(out == raw && mv.empty());
+        free(out);
+        cout << "测试VectorView无错误" << endl;
+    }
+
+    { //测试GapVector
+        GapVector<int> gv;
+        for(int ix = 0; ix != 10; ++ix)
+            gv.push_back(ix);
+        assert(gv.size() == 10 && gv.gap_position() == 10);
+        gv.insert(gv.begin() + 3, 100); //间隙移到3
+        assert(gv.gap_position() == 4 && gv[3] == 100 && gv[4] == 3 && gv.back() == 9);
+        gv.insert(gv.begin() + 4, 101); //紧接着上次的位置，不需要搬动
+        assert(gv.gap_position() == 5 && gv[4] == 101 && gv[5] == 3);
+        gv.erase(gv.begin() + 4); //退格
+        gv.erase(gv.begin() + 3);
+        Vector<int> expect;
+        for(int ix = 0; ix != 10; ++ix)
+            expect.push_back(ix);
+        assert(gv.size() == 10 && std::equal(gv.begin(), gv.end(), expect.begin()));
+        gv.erase(gv.begin() + 7, gv.end());
+        gv.erase(gv.begin(), gv.begin() + 2);
+        assert(gv.size() == 5 && gv.front() == 2 && gv.back() == 6);
+        gv.insert(gv.begin() + 2, static_cast<size_t>(3), -1);
+        assert(gv.size() == 8 && gv[1] == 3 && gv[2] == -1 && gv[4] == -1 && gv[5] == 4);
+        print(gv);
+
+        //迭代器是随机访问的，可以用于标准算法
+        GapVector<int>::iterator it = std::find(gv.begin(), gv.end(), 5);
+        assert(it - gv.begin() == 6 && *it == 5 && it[1] == 6);
+        std::sort(gv.begin(), gv.end());
+        assert(gv.front() == -1 && gv.back() == 6);
+
+        //不能按字节搬迁的元素逐个移动
+        GapVector<string> gs(static_cast<size_t>(3), "abc");
+        gs.insert(gs.begin(), "front");
+        gs.insert(gs.begin() + 2, gs[0]); //参数引用容器中的元素
+        gs.insert(gs.end(), expect.size(), "tail");
+        assert(gs.size() == 15 && gs[0] == "front" && gs[2] == "front" && gs[4] == "abc" && gs.back() == "tail");
+        GapVector<string> copy(gs);
+        gs.erase(gs.begin() + 1, gs.begin() + 5);
+        assert(gs.size() == 11 && gs[0] == "front" && gs[1] == "tail" && copy.size() == 15 && copy != gs);
+        copy = std::move(gs);
+        assert(copy.size() == 11 && copy[1] == "tail");
+
+        {
+            GapVector<Handle> gh;
+            for(int ix = 0; ix != 20; ++ix)
+                gh.insert(gh.begin() + ix / 2, Handle(ix));
+            gh.erase(gh.begin() + 3, gh.begin() + 13);
+            assert(gh.size() == 10 && Handle::live == 10);
+        }
+        assert(Handle::live == 0);
+
+        //前向迭代器的区间一次扩容
+        GapVector<int> bulk;
+        bulk.push_back(-1);
+        bulk.push_back(-2);
+        size_t allocs = g_alloc_count;
+        bulk.insert(bulk.begin() + 1, expect.begin(), expect.end());
+        assert(g_alloc_count - allocs <= 1 && bulk.size() == 12 && bulk[1] == 0 && bulk[10] == 9 && bulk[11] == -2);
+        std::istringstream words("x y z");
+        copy.insert(copy.begin() + 1, std::istream_iterator<string>(words), std::istream_iterator<string>());
+        assert(copy.size() == 14 && copy[1] == "x" && copy[3] == "z" && copy[4] == "tail");
+
+        //分配器不传播且不相等时交换元素，各自保留自己的分配器
+        typedef GapVector<string, TaggedAllocator<string> > TaggedGap;
+        TaggedGap left(static_cast<size_t>(2), "l", TaggedAllocator<string>(1));
+        TaggedGap right(static_cast<size_t>(5), "r", TaggedAllocator<string>(2));
+        left.swap(right);
+        assert(left.size() == 5 && left[4] == "r" && left.get_allocator().tag == 1);
+        assert(right.size() == 2 && right[1] == "l" && right.get_allocator().tag == 2);
+        cout << "测试GapVector无错误" << endl;
+    }
+
+    { //测试SoAVector
+        SoAVector<int, double, string> soa;
+        for(int ix = 0; ix != 100; ++ix)
+            soa.push_back(ix, ix * 0.5, "row");
+        assert(soa.size() == 100 && soa.capacity() >= 100);
+        assert(std::get<0>(soa[10]) == 10 && std::get<1>(soa[10]) == 5.0 && std::get<2>(soa.back()) == "row");
+
+        //每列连续且按缓存行对齐
+        VectorView<int> ids = soa.column<0>();
+        VectorView<double> weights = soa.column<1>();
+        assert(ids.size() == 100 && ids[99] == 99 && &ids[1] == &ids[0] + 1);
+        assert(reinterpret_cast<uintptr_t>(weights.data()) % 64 == 0);
+        double sum = 0;
+        for(VectorView<double>::iterator it = weights.begin(); it != weights.end(); ++it)
+            sum += *it;
+        assert(sum == 2475.0);
+
+        //行代理可以读写
+        std::get<1>(soa[3]) = -1.0;
+        soa[4] = std::make_tuple(40, 4.5, string("four"));
+        int id;
+        string name;
+        std::tie(id, std::ignore, name) = soa[4];
+        assert(weights[3] == -1.0 && id == 40 && name == "four");
+
+        soa.insert(soa.begin() + 1, -5, -5.0, "inserted");
+        assert(soa.size() == 101 && std::get<0>(soa[1]) == -5 && std::get<0>(soa[2]) == 1
+               && std::get<2>(soa[1]) == "inserted" && std::get<0>(soa[100]) == 99);
+        soa.erase(soa.begin(), soa.begin() + 2);
+        assert(soa.size() == 99 && std::get<0>(soa.front()) == 1);
+        soa.emplace_back(soa[0]); //参数引用容器中的元素
+        assert(std::get<0>(soa.back()) == 1 && std::get<2>(soa.back()) == "row");
+
+        SoAVector<int, double, string> copy(soa);
+        assert(copy == soa);
+        std::get<2>(copy[0]) = "changed";
+        assert(copy != soa);
+        copy.resize(10);
+        assert(copy.size() == 10);
+        copy.resize(20);
+        assert(std::get<0>(copy[19]) == 0 && std::get<2>(copy[19]).empty());
+        copy.pop_back();
+        soa = std::move(copy);
+        assert(soa.size() == 19 && std::get<2>(soa[0]) == "changed");
+
+        const SoAVector<int, double, string> &cs = soa;
+        int count = 0;
+        for(SoAVector<int, double, string>::const_iterator it = cs.begin(); it != cs.end(); ++it)
+            count += std::get<0>(*it) >= 0;
+        assert(count == 19 && cs.column<0>().size() == 19);
+
+        //随机访问迭代器的比较和加法
+        SoAVector<int, double, string>::const_iterator first = cs.begin(), last = cs.end();
+        assert(last > first && first <= first && last >= first + 19 && 19 + first == last && !(first > last));
+        SoAVector<int, double> sorted;
+        for(int ix = 0; ix != 10; ++ix)
+            sorted.push_back(ix * 2, ix * 0.5);
+        SoAVector<int, double>::iterator pos = std::lower_bound(sorted.begin(), sorted.end(), 7,
+            [](SoAVector<int, double>::reference row, int key) { return std::get<0>(row) < key; });
+        assert(pos - sorted.begin() == 4 && std::get<1>(*pos) == 2.0);
+        soa.clear();
+        assert(soa.empty());
+        cout << "测试SoAVector无错误" << endl;
+    }
+
+    { //测试对齐分配器
+        typedef Vector<float, AlignedAllocator<float, 32> > FloatVec;
+        FloatVec vec;
+        assert(vec.data() == NULL);
+        for(int ix = 0; ix != 1000; ++ix)
+        {
+            vec.push_back(static_cast<float>(ix));
+            assert(reinterpret_cast<uintptr_t>(vec.data()) % 32 == 0);
+            assert(vec.capacity() % (32 / sizeof(float)) == 0); //尾部按整个向量读取不会越界
+        }
+        assert(vec.data()[999] == 999.0f && vec.data() == &vec[0]);
+
+        vec.reserve(3); //不缩小
+        FloatVec copy(vec);
+        assert(copy == vec && reinterpret_cast<uintptr_t>(copy.data()) % 32 == 0);
+        const FloatVec &cref = copy;
+        assert(cref.data() == &copy[0]);
+
+        Vector<int, AlignedAllocator<int> > one(1, 7); //默认按缓存行对齐
+        assert(one.capacity() == 64 / sizeof(int) && reinterpret_cast<uintptr_t>(one.data()) % 64 == 0);
+
+        //大块内存按大页对齐
+        Vector<double, AlignedAllocator<double, 64> > big;
+        big.reserve(AlignedAllocator<double>::kHugePage / sizeof(double) + 1);
+        assert(reinterpret_cast<uintptr_t>(big.data()) % AlignedAllocator<double>::kHugePage == 0);
+        assert(big.capacity() == 2 * AlignedAllocator<double>::kHugePage / sizeof(double));
+        big.resize(10, 1.5);
+        assert(big.back() == 1.5);
+
+        //Vector<string>的元素也可以对齐
+        Vector<string, AlignedAllocator<string> > names(3, "aligned");
+        names.push_back("more");
+        assert(reinterpret_cast<uintptr_t>(names.data()) % 64 == 0 && names[3] == "more");
+        cout << "测试对齐分配器无错误" << endl;
+    }
+
+    { //测试CowVector
+        CowVector<string> empty;
+        assert(empty.empty() && empty.use_count() == 0 && empty.begin() == empty.end());
+
+        Vector<string> loaded(1000, "config");
+        const string *storage = loaded.begin();
+        CowVector<string> table(std::move(loaded));
+        assert(loaded.empty() && table.data() == storage && table.size() == 1000); //接管而不是复制
+
+        //拷贝只共享数据
+        size_t before = g_alloc_count;
+        Vector<CowVector<string> > workers;
+        workers.reserve(32);
+        for(int ix = 0; ix != 32; ++ix)
+            workers.push_back(table);
+        assert(g_alloc_count - before == 1 && table.use_count() == 33);
+        assert(workers[5].data() == storage && workers[5] == table);
+
+        //第一次修改时复制
+        workers[5].push_back(workers[5][0]);
+        assert(workers[5].size() == 1001 && workers[5].back() == "config");
+        assert(workers[5].data() != storage && workers[5].unique() && table.use_count() == 32);
+        workers[6].make_unique()[0] = "changed";
+        assert(workers[6][0] == "changed" && table[0] == "config" && workers[6] != table);
+        const string *own = workers[6].data();
+        workers[6].make_unique()[1] = "again"; //已经独占，不再复制
+        assert(workers[6].data() == own);
+        workers[7].insert(workers[7].begin() + 1, workers[7][0]);
+        workers[8].erase(workers[8].begin(), workers[8].begin() + 10);
+        assert(workers[7].size() == 1001 && workers[8].size() == 990 && table.size() == 1000);
+
+        CowVector<string> moved(std::move(workers[9]));
+        assert(workers[9].empty() && moved.data() == storage);
+        workers[10] = workers[6];
+        assert(workers[10].data() == own && workers[6].use_count() == 2);
+        workers[10].clear();
+        assert(workers[10].empty() && workers[6].unique());
+
+        //共享块和复制出的数据都从容器的分配器中分配
+        Arena arena(1024);
+        typedef CowVector<string, ArenaAllocator<string> > ArenaCow;
+        ArenaCow ac(static_cast<ArenaCow::size_type>(3), "arena", ArenaAllocator<string>(arena));
+        assert(arena.reserved() != 0 && ac.get_allocator().arena() == &arena);
+        ArenaCow ac2(ac);
+        ac2.push_back("more"); //复制一份，仍在arena中
+        assert(ac2.size() == 4 && ac.size() == 3 && ac2.get_allocator().arena() == &arena);
+        ArenaCow lazy((ArenaAllocator<string>(arena)));
+        lazy.push_back("first");
+        assert(lazy[0] == "first" && lazy.get_allocator().arena() == &arena);
+
+        //多个线程同时拷贝、读取和释放共享的数据
+        CowVector<int> shared(10000, 7);
+        std::atomic<long> total(0);
+        std::thread threads[4];
+        for(int t = 0; t != 4; ++t)
+            threads[t] = std::thread([&shared, &total, t]() {
+                for(int round = 0; round != 100; ++round)
+                {
+                    CowVector<int> mine(shared);
+                    if(round % 10 == t)
+                        mine.make_unique()[0] = t;
+                    total += mine[9999];
+                }
+            });
+        for(int t = 0; t != 4; ++t)
+            threads[t].join();
+        assert(total == 4 * 100 * 7 && shared.unique() && shared[0] == 7);
+        cout << "测试CowVector无错误" << endl;
+    }
+
+    { //测试批量追加和不初始化的resize
+        Vector<int> vec(3, 1);
+        vec.append_n(5, 2);
+        assert(vec.size() == 8 && vec[2] == 1 && vec[3] == 2 && vec[7] == 2);
+        vec.append_n(100, vec[0]); //参数引用容器中的元素，扩容后仍然正确
+        assert(vec.size() == 108 && vec.back() == 1);
+        vec.append_n(0, 9);
+        assert(vec.size() == 108);
+
+        //新增的元素不写内存，旧的元素保留
+        vec.resize_uninitialized(1000);
+        assert(vec.size() == 1000 && vec[0] == 1 && vec[107] == 1);
+        vec.resize_default_init(5);
+        assert(vec.size() == 5 && vec[4] == 2);
+
+        //直接写入内存，返回实际的元素个数
+        Vector<char> buf;
+        buf.resize_and_overwrite(64, [](char *p, size_t n) {
+            assert(n == 64);
+            const char msg[] = "hello";
+            memcpy(p, msg, 5);
+            return size_t(5);
+        });
+        assert(buf.size() == 5 && buf.capacity() >= 64 && buf[4] == 'o');
+        buf.resize_and_overwrite(8, [](char *p, size_t n) { p[5] = '!'; return n - 2; });
+        assert(buf.size() == 6 && buf[0] == 'h' && buf[5] == '!');
+        bool threw = false;
+        try
+        {
+            buf.resize_and_overwrite(4, [](char *, size_t) -> size_t { throw std::runtime_error("read"); });
+        }
+        catch(const std::runtime_error &)
+        {
+            threw = true;
+        }
+        assert(threw && buf.size() == 6);
+
+        //不是可平凡构造的类型仍然调用默认构造函数
+        int live = Handle::live;
+        {
+            Vector<Handle> handles(2, Handle(5));
+            handles.resize_default_init(10);
+            assert(Handle::live == live + 10 && *handles[9].p == 0 && *handles[1].p == 5);
+            handles.append_n(3, handles[0]);
+            assert(Handle::live == live + 13 && *handles[12].p == 5);
+            handles.resize_default_init(1);
+            assert(Handle::live == live + 1);
+        }
+        assert(Handle::live == live);
+        cout << "测试批量追加和不初始化的resize无错误" << endl;
+    }
+
+    { //测试FlatSet和FlatMap
+        int keys[] = { 5, 3, 9, 3, 1, 7, 5 };
+        FlatSet<int> set(keys, keys + 7);
+        int sorted[] = { 1, 3, 5, 7, 9 };
+        assert(set.size() == 5 && std::equal(set.begin(), set.end(), sorted));
+        assert(set.contains(7) && !set.contains(4) && set.count(3) == 1);
+        assert(*set.lower_bound(4) == 5 && *set.upper_bound(5) == 7 && set.lower_bound(10) == set.end());
+        assert(set.find(0) == set.end() && *set.find(9) == 9);
+        for(int k = -1; k != 12; ++k) //无分支的查找和std::lower_bound一致
+            assert(set.lower_bound(k) == std::lower_bound(set.begin(), set.end(), k));
+
+        assert(set.insert(4).second && !set.insert(4).second && set.size() == 6);
+        assert(set.erase(3) == 1 && set.erase(3) == 0 && set.size() == 5);
+
+        //批量插入：新的键和已有的键交错、重复
+        int more[] = { 8, 0, 4, 100, 8, -3 };
+        set.insert(more, more + 6);
+        int merged[] = { -3, 0, 1, 4, 5, 7, 8, 9, 100 };
+        assert(set.size() == 9 && std::equal(set.begin(), set.end(), merged));
+        int tail[] = { 200, 150 };
+        set.insert(tail, tail + 2); //都比已有的大，只排序新的部分
+        assert(set.size() == 11 && *(set.end() - 1) == 200 && *(set.end() - 2) == 150);
+
+        //比较使用Vector的运算符
+        FlatSet<int> other(set.sequence().begin(), set.sequence().end());
+        assert(other == set && !(other < set));
+        other.erase(other.begin());
+        assert(other != set && set < other);
+
+        Vector<int> raw(100);
+        for(int ix = 0; ix != 100; ++ix)
+            raw[ix] = (ix * 37) % 50;
+        FlatSet<int, std::greater<int> > desc(std::move(raw));
+        assert(desc.size() == 50 && *desc.begin() == 49 && *desc.lower_bound(10) == 10);
+
+        //FlatMap：重复的键保留第一次出现的值
+        std::pair<string, int> entries[] = {
+            std::make_pair("pear", 3), std::make_pair("apple", 1), std::make_pair("fig", 2),
+            std::make_pair("apple", 99)
+        };
+        FlatMap<string, int> map(entries, entries + 4);
+        assert(map.size() == 3 && map.begin()->first == "apple" && map.at("apple") == 1);
+        assert(map["fig"] == 2 && map["kiwi"] == 0 && map.size() == 4);
+        map["kiwi"] = 7;
+        map.find("pear")->second = 30;
+        assert(map.at("kiwi") == 7 && map.at("pear") == 30);
+        assert(!map.insert(std::make_pair(string("fig"), 20)).second && map.at("fig") == 2);
+        assert(!map.insert_or_assign("fig", 20).second && map.at("fig") == 20);
+        assert(map.insert_or_assign("date", 4).second && (map.begin() + 1)->first == "date");
+        bool threw = false;
+        try
+        {
+            map.at("none");
+        }
+        catch(const std::out_of_range &)
+        {
+            threw = true;
+        }
+        assert(threw);
+
+        std::pair<string, int> batch[] = { std::make_pair("apple", 5), std::make_pair("banana", 6) };
+        map.insert(batch, batch + 2);
+        assert(map.size() == 6 && map.at("apple") == 1 && map.at("banana") == 6);
+        const FlatMap<string, int> &cmap = map;
+        assert(cmap.at("date") == 4 && cmap.find("zzz") == cmap.end());
+        assert(map.erase("apple") == 1 && map.begin()->first == "banana");
+
+        //operator[]只在插入时构造值
+        FlatMap<int, Counted> counted;
+        counted[1];
+        counted[1];
+        counted[2];
+        assert(counted.size() == 2 && Counted::made == 2);
+        cout << "测试FlatSet和FlatMap无错误" << endl;
+    }
+
+    { //测试批量删除
+        Vector<int> ints;
+        for(int ix = 0; ix != 100; ++ix)
+            ints.push_back(ix);
+        assert(ints.erase_if([](int v) { return v % 3 == 0; }) == 34);
+        assert(ints.size() == 66 && ints[0] == 1 && ints[1] == 2 && ints[2] == 4 && ints.back() == 98);
+        assert(ints.erase_if([](int v) { return v > 1000; }) == 0 && ints.size() == 66);
+
+        size_t idx[] = { 0, 2, 2, 65 };
+        assert(ints.remove_indices(idx, idx + 4) == 3);
+        assert(ints.size() == 63 && ints[0] == 2 && ints[1] == 5 && ints.back() == 97);
+        size_t bad[] = { 3, 1 };
+        bool threw = false;
+        try
+        {
+            ints.remove_indices(bad, bad + 2);
+        }
+        catch(const std::out_of_range &)
+        {
+            threw = true;
+        }
+        assert(threw && ints.size() == 63);
+
+        assert(*ints.swap_erase(ints.begin()) == 97 && ints.size() == 62 && ints[1] == 5);
+        assert(ints.swap_erase(ints.end() - 1) == ints.end());
+
+        //逐个移动赋值的类型
+        Vector<string> words;
+        const char *text[] = { "keep", "drop", "keep", "drop", "drop", "tail" };
+        for(int ix = 0; ix != 6; ++ix)
+            words.push_back(text[ix]);
+        assert(words.erase_if([](const string &w) { return w == "drop"; }) == 3);
+        assert(words.size() == 3 && words[1] == "keep" && words[2] == "tail");
+        size_t first[] = { 0 };
+        words.remove_indices(first, first + 1);
+        assert(words.size() == 2 && words[0] == "keep");
+
+        //按字节搬迁的类型：删除的元素各析构一次
+        int live = Handle::live;
+        {
+            Vector<Handle> handles;
+            for(int ix = 0; ix != 20; ++ix)
+                handles.push_back(Handle(ix));
+            assert(handles.erase_if([](const Handle &h) { return *h.p % 2 == 1; }) == 10);
+            assert(Handle::live == live + 10 && *handles[3].p == 6 && *handles.back().p == 18);
+            size_t some[] = { 1, 2, 9 };
+            assert(handles.remove_indices(some, some + 3) == 3);
+            assert(Handle::live == live + 7 && *handles[0].p == 0 && *handles[1].p == 6 && *handles.back().p == 16);
+            //pred抛出异常时留下的元素仍然完整
+            threw = false;
+            try
+            {
+                handles.erase_if([](const Handle &h) -> bool {
+                    if(*h.p == 10)
+                        throw std::runtime_error("pred");
+                    return *h.p == 8;
+                });
+            }
+            catch(const std::runtime_error &)
+            {
+                threw = true;
+            }
+            assert(threw && Handle::live == live + 6 && handles.size() == 6 && *handles[2].p == 10);
+            handles.swap_erase(handles.begin());
+            assert(Handle::live == live + 5 && *handles[0].p == 16);
+        }
+        assert(Handle::live == live);
+
+        //只能移动的类型
+        Vector<std::unique_ptr<int> > owners;
+        for(int ix = 0; ix != 10; ++ix)
+            owners.push_back(std::unique_ptr<int>(new int(ix)));
+        owners.erase_if([](const std::unique_ptr<int> &p) { return *p < 5; });
+        size_t last[] = { 4 };
+        owners.remove_indices(last, last + 1);
+        owners.swap_erase(owners.begin());
+        assert(owners.size() == 3 && *owners[0] == 8 && *owners[1] == 6);
+        cout << "测试批量删除无错误" << endl;
+    }
+
+    { //测试收缩容量
+        Vector<int> vec(1000, 3);
+        vec.resize(10);
+        assert(vec.capacity() == 1000); //默认的增长策略不自动收缩
+        vec.shrink_to_fit();
+        assert(vec.capacity() == 10 && vec.size() == 10 && vec.back() == 3);
+        vec.clear();
+        vec.shrink_to_fit();
+        assert(vec.capacity() == 0 && vec.data() == NULL);
+        vec.push_back(1);
+        assert(vec.size() == 1);
+
+        Vector<string> words(100, "word");
+        words.erase(words.begin() + 5, words.end());
+        words.shrink_to_fit();
+        assert(words.capacity() == 5 && words[4] == "word");
+        Vector<int, MallocAllocator<int> > mv(100000, 1); //reallocate原地收缩
+        mv.resize(3);
+        mv.shrink_to_fit();
+        assert(mv.capacity() == 3 && mv[2] == 1);
+
+        //SmallVector：内部缓冲区不缩小，堆上的元素不多时回到缓冲区
+        SmallVector<int, 8> small;
+        small.push_back(1);
+        small.shrink_to_fit();
+        assert(small.isSmall() && small.capacity() == 8);
+        for(int ix = 0; ix != 20; ++ix)
+            small.push_back(ix);
+        assert(!small.isSmall());
+        small.resize(4);
+        small.shrink_to_fit();
+        assert(small.isSmall() && small.size() == 4 && small[3] == 2);
+
+        //自动收缩：少于容量的1/4时收缩到元素个数的2倍
+        typedef Vector<int, std::allocator<int>, AutoTrim<GrowDouble, 4, 64> > TrimVec;
+        TrimVec trim;
+        for(int ix = 0; ix != 1024; ++ix)
+            trim.push_back(ix);
+        assert(trim.capacity() == 1024);
+        trim.resize(300);
+        assert(trim.capacity() == 1024); //还没有少于1/4
+        trim.resize(200);
+        assert(trim.capacity() == 400 && trim.back() == 199);
+        //阈值附近反复增删不会重新分配
+        const int *storage = trim.data();
+        for(int round = 0; round != 100; ++round)
+        {
+            trim.push_back(round);
+            trim.pop_back();
+            trim.erase(trim.begin());
+            trim.push_back(round);
+        }
+        assert(trim.data() == storage && trim.size() == 200);
+        TrimVec::iterator it = trim.erase(trim.begin() + 10, trim.end() - 50); //返回收缩后的位置
+        assert(trim.capacity() == 120 && it == trim.begin() + 10 && *it == trim[10]);
+        trim.clear();
+        assert(trim.capacity() == 64 / sizeof(int));
+
+        //注册表：内存紧张时统一收缩
+        Vector<double> cache(10000, 1.0);
+        cache.resize(100);
+        size_t before = VectorTrimRegistry::instance().size();
+        std::ostringstream log;
+        {
+            ScopedVectorTrim reg("cache", cache);
+            std::mutex lock;
+            Vector<string> guarded(50, "x");
+            guarded.clear();
+            ScopedVectorTrim custom("guarded", [&lock, &guarded]() -> size_t {
+                std::lock_guard<std::mutex> hold(lock);
+                size_t bytes = guarded.capacity() * sizeof(string);
+                guarded.shrink_to_fit();
+                return bytes;
+            });
+            assert(VectorTrimRegistry::instance().size() == before + 2);
+            size_t freed = VectorTrimRegistry::instance().trim_all(&log);
+            assert(freed == 9900 * sizeof(double) + 50 * sizeof(string));
+            assert(cache.capacity() == 100 && guarded.capacity() == 0);
+            assert(VectorTrimRegistry::instance().trim_all() == 0);
+        }
+        assert(VectorTrimRegistry::instance().size() == before);
+        assert(log.str().find("cache: 79200 bytes") != string::npos);
+
+        //回调在锁外执行，可以注册别的容器；左值的可调用对象按值保存
+        {
+            Vector<int> inner(100);
+            inner.clear();
+            std::unique_ptr<ScopedVectorTrim> late, copied;
+            ScopedVectorTrim nested("nested", [&late, &inner]() -> size_t {
+                if(!late)
+                    late.reset(new ScopedVectorTrim("late", inner));
+                return 0;
+            });
+            {
+                auto fn = []() -> size_t { return 7; };
+                copied.reset(new ScopedVectorTrim("copied", fn));
+            }
+            assert(VectorTrimRegistry::instance().trim_all() == 7);
+            assert(late && VectorTrimRegistry::instance().size() == before + 3);
+            assert(VectorTrimRegistry::instance().trim_all() == 7 + 100 * sizeof(int));
+            assert(copied->trim() == 7 && inner.capacity() == 0);
+        }
+        assert(VectorTrimRegistry::instance().size() == before);
+        cout << "测试收缩容量无错误" << endl;
+    }
+
+    { //测试BitVector
+        typedef BitVector<> Bits;
+        Bits bits;
+        assert(bits.empty() && bits.count() == 0 && bits.find_first() == Bits::npos);
+
+        //与逐字节保存的结果对照，长度跨过多个字和AVX2的4字一组
+        Vector<bool> ref;
+        uint32_t seed = 12345;
+        for(int ix = 0; ix != 1000; ++ix)
+        {
+            seed = seed * 1103515245 + 12345;
+            bool v = (seed >> 16) % 3 == 0;
+            bits.push_back(v);
+            ref.push_back(v);
+        }
+        assert(bits.size() == 1000 && bits.num_words() == 16 && bits.capacity() >= 1000);
+        size_t ones = std::count(ref.begin(), ref.end(), true);
+        assert(bits.count() == ones);
+        assert(std::equal(ref.begin(), ref.end(), bits.begin()));
+        assert(std::count(bits.begin(), bits.end(), true) == static_cast<ptrdiff_t>(ones));
+        assert(bits.end() - bits.begin() == 1000);
+
+        //find_first/find_next遍历所有的1，rank/select互逆
+        size_t visited = 0;
+        for(size_t pos = bits.find_first(); pos != Bits::npos; pos = bits.find_next(pos))
+        {
+            assert(ref[pos]);
+            assert(bits.rank(pos) == visited);
+            assert(bits.select(visited) == pos);
+            ++visited;
+        }
+        assert(visited == ones && bits.rank(1000) == ones && bits.select(ones) == Bits::npos);
+
+        BitRankIndex index(bits);
+        assert(index.count() == ones);
+        for(size_t pos = 0; pos <= 1000; ++pos)
+            assert(index.rank(pos) == bits.rank(pos));
+        for(size_t k = 0; k != ones; ++k)
+            assert(index.select(k) == bits.select(k));
+        assert(index.select(ones) == BitRankIndex::npos);
+
+        //代理引用
+        bits[3] = true;
+        bits[4] = bits[3];
+        assert(bits[3] && bits.test(4));
+        bits[4].flip();
+        assert(!bits[4] && ~bits[4]);
+        bits.reset(3);
+        bits.flip(5);
+        assert(!bits.test(3) && bits.test(5) == !ref[5]);
+        *(bits.begin() + 5) = ref[5];
+        bits.set(4, ref[4]);
+        bits.set(3, ref[3]);
+        assert(std::equal(ref.begin(), ref.end(), bits.begin()));
+        Bits::const_iterator cit = bits.begin();
+        assert(*(cit + 999) == ref[999] && cit[7] == ref[7]);
+
+        //逐位运算，末尾多出来的位保持为0
+        Bits other(1000);
+        for(size_t pos = 0; pos < 1000; pos += 7)
+            other[pos] = true;
+        Bits a(bits), o(bits), x(bits), n(bits);
+        a &= other;
+        o |= other;
+        x ^= other;
+        n.and_not(other);
+        for(size_t pos = 0; pos != 1000; ++pos)
+        {
+            bool l = ref[pos], r = pos % 7 == 0;
+            assert(a[pos] == (l && r) && o[pos] == (l || r) && x[pos] == (l != r) && n[pos] == (l && !r));
+        }
+        assert(a.count() + x.count() == o.count());
+        Bits all(1000, true);
+        assert(all.count() == 1000 && (all.data()[15] >> (1000 % 64)) == 0);
+        all.flip();
+        assert(all.none() && all.num_words() == 16);
+        all.set();
+        all ^= bits;
+        assert(all.count() == 1000 - ones);
+        bool caught = false;
+        try
+        {
+            a &= Bits(999);
+        }
+        catch(std::invalid_argument &)
+        {
+            caught = true;
+        }
+        assert(caught);
+
+        //resize、pop_back和比较
+        Bits small(3, true);
+        small.resize(70, true);
+        assert(small.count() == 70 && small.num_words() == 2);
+        small.resize(65);
+        assert(small.count() == 65 && small.back());
+        small.resize(130);
+        assert(small.count() == 65 && !small.test(100));
+        small.resize(64);
+        small.pop_back();
+        assert(small.size() == 63 && small.num_words() == 1 && small.count() == 63);
+        small.push_back(false);
+        small.push_back(true);
+        assert(small.num_words() == 2 && small.find_next(62) == 64);
+        small.pop_back();
+        small.pop_back();
+        assert(small == Bits(63, true) && small != Bits(63));
+        small.reset();
+        assert(small.none() && small.size() == 63);
+        small.clear();
+        assert(small.empty() && small.num_words() == 0);
+        Bits swapped;
+        swapped.swap(bits);
+        assert(bits.empty() && swapped.count() == ones);
+        cout << "测试BitVector无错误" << endl;
+    }
+
+    { //测试PackedIntVector
+        //取值范围小的id：每块按位数存放，与原始数据逐个对照
+        Vector<uint32_t> ids;
+        uint32_t seed = 7;
+        for(int ix = 0; ix != 1000; ++ix)
+        {
+            seed = seed * 1103515245 + 12345;
+            ids.push_back(100000 + (seed >> 16) % 1000);
+        }
+        PackedIntVector<uint32_t> packed(ids.begin(), ids.end());
+        assert(packed.size() == 1000 && packed.num_blocks() == 8);
+        for(size_t ix = 0; ix != ids.size(); ++ix)
+            assert(packed[ix] == ids[ix]);
+        assert(std::equal(ids.begin(), ids.end(), packed.begin()));
+        size_t visited = 0;
+        packed.for_each([&](uint32_t v) { assert(v == ids[visited]); ++visited; });
+        assert(visited == 1000);
+        assert(packed.front() == ids.front() && packed.back() == ids.back());
+        assert(packed.compression_ratio() > 2);
+        bool caught = false;
+        try
+        {
+            packed.at(1000);
+        }
+        catch(std::out_of_range &)
+        {
+            caught = true;
+        }
+        assert(caught);
+
+        //有序的id用差分，压缩比在3倍以上；整块解码
+        Vector<uint64_t> sorted;
+        uint64_t id = 1ull << 40;
+        for(int ix = 0; ix != 10000; ++ix)
+        {
+            seed = seed * 1103515245 + 12345;
+            id += 1 + (seed >> 16) % 64;
+            sorted.push_back(id);
+        }
+        PackedIntVector<uint64_t, DeltaCoding> deltas(sorted.begin(), sorted.end());
+        assert(deltas.compression_ratio() > 6);
+        assert(deltas.memory_bytes() < sorted.size() * sizeof(uint64_t) / 4);
+        for(size_t ix = 0; ix < sorted.size(); ix += 37)
+            assert(deltas[ix] == sorted[ix]);
+        uint64_t block[PackedIntVector<uint64_t>::kBlockSize];
+        assert(deltas.decode_block(3, block) == 128 && std::equal(block, block + 128, sorted.begin() + 384));
+        assert(deltas.decode_block(78, block) == 16 && block[15] == sorted.back());
+        assert(std::equal(sorted.begin(), sorted.end(), deltas.begin()));
+        PackedIntVector<uint64_t, DeltaCoding>::const_iterator it = deltas.begin(), prev = it++;
+        assert(*prev == sorted[0] && *it == sorted[1]);
+
+        //任意数据都能还原：有符号、乱序时的差分、需要全部位数的块
+        Vector<int> mixed;
+        for(int ix = 0; ix != 300; ++ix)
+            mixed.push_back(ix % 3 == 0 ? -ix * 1000 : ix);
+        mixed[5] = std::numeric_limits<int>::min();
+        mixed[6] = std::numeric_limits<int>::max();
+        PackedIntVector<int> signed_for(mixed.begin(), mixed.end());
+        PackedIntVector<int, DeltaCoding> signed_delta(mixed.begin(), mixed.end());
+        assert(std::equal(mixed.begin(), mixed.end(), signed_for.begin()));
+        assert(std::equal(mixed.begin(), mixed.end(), signed_delta.begin()));
+        for(size_t ix = 0; ix != mixed.size(); ++ix)
+            assert(signed_for[ix] == mixed[ix] && signed_delta[ix] == mixed[ix]);
+        PackedIntVector<uint64_t> wide;
+        for(int ix = 0; ix != 256; ++ix)
+            wide.push_back(ix % 2 ? ~0ull - ix : ix);
+        for(int ix = 0; ix != 256; ++ix)
+            assert(wide[ix] == (ix % 2 ? ~0ull - ix : static_cast<uint64_t>(ix)));
+
+        //整块相同的值不占位
+        PackedIntVector<uint32_t> constant;
+        for(int ix = 0; ix != 256; ++ix)
+            constant.push_back(42);
+        assert(constant[255] == 42 && constant.compression_ratio() > 20);
+        constant.clear();
+        assert(constant.empty() && constant.begin() == constant.end());
+        cout << "测试PackedIntVector无错误" << endl;
+    }
+
+    { //测试RingVector
+        //两端随机插入删除，与deque对照；string走逐个搬迁，int走memcpy
+        RingVector<string> ring;
+        RingVector<int> ints;
+        std::deque<string> ref;
+        uint32_t seed = 3;
+        for(int ix = 0; ix != 5000; ++ix)
+        {
+            seed = seed * 1103515245 + 12345;
+            unsigned op = (seed >> 16) % 5;
+            if(op == 0 && !ref.empty())
+            {
+                assert(ring.front() == ref.front() && ints.front() == atoi(ref.front().c_str()));
+                ring.pop_front();
+                ints.pop_front();
+                ref.pop_front();
+            }
+            else if(op == 1 && !ref.empty())
+            {
+                assert(ring.back() == ref.back() && ints.back() == atoi(ref.back().c_str()));
+                ring.pop_back();
+                ints.pop_back();
+                ref.pop_back();
+            }
+            else if(op == 2)
+            {
+                ring.push_front(std::to_string(ix));
+                ints.push_front(ix);
+                ref.push_front(std::to_string(ix));
+            }
+            else
+            {
+                ring.push_back(std::to_string(ix));
+                ints.emplace_back(ix);
+                ref.push_back(std::to_string(ix));
+            }
+            assert(ring.size() == ref.size() && ints.size() == ref.size());
+        }
+        assert(std::equal(ref.begin(), ref.end(), ring.begin()));
+        assert(ring.end() - ring.begin() == static_cast<ptrdiff_t>(ref.size()));
+        for(size_t ix = 0; ix != ref.size(); ++ix)
+            assert(ring[ix] == ref[ix] && ring.at(ix) == ref[ix] && ints[ix] == atoi(ref[ix].c_str()));
+        bool caught = false;
+        try
+        {
+            ring.at(ring.size());
+        }
+        catch(std::out_of_range &)
+        {
+            caught = true;
+        }
+        assert(caught);
+
+        //跨过缓冲区末尾时迭代器绕回开头，排序等随机访问算法可以直接用
+        RingVector<int> wrapped;
+        wrapped.reserve(8);
+        for(int ix = 0; ix != 6; ++ix)
+            wrapped.push_back(ix);
+        for(int ix = 0; ix != 4; ++ix)
+        {
+            wrapped.pop_front();
+            wrapped.push_back(10 - ix);
+        }
+        assert(wrapped.capacity() == 8 && !wrapped.is_contiguous());
+        std::sort(wrapped.begin(), wrapped.end());
+        const int sorted[] = {4, 5, 7, 8, 9, 10};
+        assert(std::equal(sorted, sorted + 6, wrapped.begin()));
+        RingVector<int>::const_iterator cit = wrapped.end();
+        assert(*(cit - 1) == 10 && cit[-6] == 4);
+        int *flat = wrapped.as_contiguous();
+        assert(wrapped.is_contiguous() && flat == &wrapped.front() && std::equal(sorted, sorted + 6, flat));
+        assert(wrapped.capacity() == 8 && wrapped.as_contiguous() == flat);
+        ring.push_front("head");
+        string *strings = ring.as_contiguous();
+        assert(ring.is_contiguous() && strings[0] == "head" && std::equal(ref.begin(), ref.end(), strings + 1));
+
+        //扩容时参数引用自己的元素
+        RingVector<string> self(1, "first");
+        self.push_back(self.front());
+        self.push_front(self.back());
+        assert(self.size() == 3 && self[0] == "first" && self[2] == "first");
+
+        //固定容量时覆盖另一端的元素
+        RingVector<string> recent = RingVector<string>::bounded(3);
+        assert(recent.bound() == 3 && recent.capacity() == 3);
+        for(int ix = 0; ix != 10; ++ix)
+            recent.push_back(std::to_string(ix));
+        assert(recent.full() && recent.capacity() == 3);
+        assert(recent[0] == "7" && recent[1] == "8" && recent[2] == "9");
+        recent.push_front("x");
+        assert(recent.size() == 3 && recent.front() == "x" && recent.back() == "8");
+        recent.push_back(recent.front());
+        assert(recent[0] == "7" && recent[2] == "x");
+        RingVector<string> copy(recent);
+        assert(copy == recent && copy.bound() == 3);
+        copy.push_back("y");
+        assert(copy.size() == 3 && copy != recent && recent < copy);
+        caught = false;
+        try
+        {
+            copy.reserve(4);
+        }
+        catch(std::length_error &)
+        {
+            caught = true;
+        }
+        assert(caught);
+        recent.clear();
+        assert(recent.empty() && recent.bound() == 3);
+        RingVector<string> moved(std::move(copy));
+        assert(moved.size() == 3 && copy.empty() && copy.bound() == 0);
+
+        //分配器不传播且不相等时交换元素，各自保留自己的分配器和固定容量
+        typedef RingVector<string, TaggedAllocator<string> > TaggedRing;
+        TaggedRing left(static_cast<size_t>(2), "l", TaggedAllocator<string>(1));
+        TaggedRing right(static_cast<size_t>(5), "r", TaggedAllocator<string>(2));
+        right.pop_front();
+        right.push_back("last"); //跨过缓冲区末尾
+        left.swap(right);
+        assert(left.size() == 5 && left[0] == "r" && left[4] == "last" && left.get_allocator().tag == 1);
+        assert(right.size() == 2 && right[1] == "l" && right.get_allocator().tag == 2);
+        TaggedRing small = TaggedRing::bounded(3, TaggedAllocator<string>(3));
+        caught = false;
+        try
+        {
+            small.swap(left);
+        }
+        catch(std::length_error &)
+        {
+            caught = true;
+        }
+        assert(caught && small.empty() && left.size() == 5);
+        small.swap(right);
+        assert(small.size() == 2 && small.bound() == 3 && right.empty());
+        cout << "测试RingVector无错误" << endl;
+    }
+
     return 0;
 }
 